@@ -0,0 +1,63 @@
+// Compara o alocador padrão (new por nó) com o pool em blocos.
+//
+// Compilação:
+//   g++ benchmarks/bench_allocator.cpp src/contact.cpp -Iinclude -O2 -std=c++17 -o bench_allocator.exe
+// Uso:
+//   ./bench_allocator.exe            (10K, 1M e 10M nós)
+//   ./bench_allocator.exe 10000 ...  (tamanhos escolhidos)
+
+#include <cstdio>
+#include "avl_tree.h"
+#include "bench_utils.h"
+
+template<template<typename> class Alloc>
+void runBenchmark(const char* label, const std::vector<Contact>& contacts) {
+    BenchTimer timer;
+    double insertMs, searchMs, churnMs, destroyMs;
+    long found = 0;
+
+    {
+        auto* tree = new AVLTree<Contact, Alloc>();
+
+        for (const auto& contact : contacts) {
+            tree->insert(contact);
+        }
+        insertMs = timer.elapsedMs();
+
+        timer.reset();
+        for (const auto& contact : contacts) {
+            found += tree->contains(contact);
+        }
+        searchMs = timer.elapsedMs();
+
+        // Remove e reinsere metade: mede o reaproveitamento de nós
+        timer.reset();
+        for (size_t i = 0; i < contacts.size(); i += 2) {
+            tree->remove(contacts[i]);
+        }
+        for (size_t i = 0; i < contacts.size(); i += 2) {
+            tree->insert(contacts[i]);
+        }
+        churnMs = timer.elapsedMs();
+
+        timer.reset();
+        delete tree;
+        destroyMs = timer.elapsedMs();
+    }
+
+    std::printf("  %-6s inserção %9.1f ms | busca %9.1f ms | remove+reinsere %9.1f ms | destruição %8.1f ms\n",
+                label, insertMs, searchMs, churnMs, destroyMs);
+    if (found != (long)contacts.size()) {
+        std::printf("  ERRO: %ld de %zu encontrados\n", found, contacts.size());
+    }
+}
+
+int main(int argc, char** argv) {
+    for (int n : benchSizes(argc, argv, {10000, 1000000, 10000000})) {
+        std::printf("n = %d\n", n);
+        auto contacts = benchContacts(n);
+        runBenchmark<HeapNodeAllocator>("heap", contacts);
+        runBenchmark<PoolNodeAllocator>("pool", contacts);
+    }
+    return 0;
+}
@@ -0,0 +1,60 @@
+// Compara a AVL com a árvore B+ em buscas aleatórias e varredura em ordem.
+//
+// Compilação:
+//   g++ benchmarks/bench_btree.cpp src/contact.cpp -Iinclude -O2 -std=c++17 -o bench_btree.exe
+// Uso:
+//   ./bench_btree.exe            (10K, 1M e 10M contatos)
+//   ./bench_btree.exe 100000 ... (tamanhos escolhidos)
+
+#include <cstdio>
+#include "avl_tree.h"
+#include "bplus_tree.h"
+#include "bench_utils.h"
+
+template<typename Tree>
+void runBenchmark(const char* label, const std::vector<Contact>& contacts,
+                  const std::vector<Contact>& lookups) {
+    BenchTimer timer;
+    auto* tree = new Tree();
+    for (const auto& contact : contacts) {
+        tree->insert(contact);
+    }
+    double insertMs = timer.elapsedMs();
+
+    timer.reset();
+    long found = 0;
+    for (const auto& key : lookups) {
+        found += tree->contains(key);
+    }
+    double lookupMs = timer.elapsedMs();
+
+    // Varredura completa em ordem, lendo o nome de cada contato
+    timer.reset();
+    std::size_t scanned = 0;
+    for (const Contact& contact : *tree) {
+        scanned += contact.getName().size();
+    }
+    double scanMs = timer.elapsedMs();
+
+    bool valid = tree->isBalanced();
+    delete tree;
+
+    double n = contacts.size();
+    std::printf("  %-5s inserção %8.1f ms | busca %8.1f ms (%6.2f M/s) | varredura %7.1f ms (%7.1f M/s)%s\n",
+                label, insertMs, lookupMs, lookups.size() / lookupMs / 1000.0,
+                scanMs, n / scanMs / 1000.0, valid ? "" : " INVÁLIDA");
+    if (found != (long)lookups.size() || scanned == 0) {
+        std::printf("  ERRO: %ld de %zu encontrados\n", found, lookups.size());
+    }
+}
+
+int main(int argc, char** argv) {
+    for (int n : benchSizes(argc, argv, {10000, 1000000, 10000000})) {
+        std::printf("n = %d\n", n);
+        auto contacts = benchContacts(n);
+        auto lookups = benchContacts(n, 7); // Mesmos contatos em outra ordem
+        runBenchmark<AVLTree<Contact>>("avl", contacts, lookups);
+        runBenchmark<BPlusTree<Contact>>("b+", contacts, lookups);
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+// Vazão de leitura da ConcurrentAVLTree com 95% leituras / 5% escritas,
+// de 1 até N threads, comparada a um std::mutex exclusivo.
+//
+// Compilação:
+//   g++ benchmarks/bench_concurrent.cpp src/contact.cpp -Iinclude -O2 -std=c++17 -pthread -o bench_concurrent.exe
+// Uso:
+//   ./bench_concurrent.exe              (1M contatos, até hardware_concurrency threads)
+//   ./bench_concurrent.exe 100000 16    (contatos, máximo de threads)
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include "concurrent_avl_tree.h"
+#include "bench_utils.h"
+
+static const int OpsPerThread = 200000;
+
+// Mesma interface mínima, mas com um único mutex exclusivo
+class ExclusiveAVLTree {
+public:
+    bool insert(const Contact& c) { std::lock_guard<std::mutex> lock(mutex); return tree.insert(c); }
+    bool remove(const Contact& c) { std::lock_guard<std::mutex> lock(mutex); return tree.remove(c); }
+    bool contains(const Contact& c) const { std::lock_guard<std::mutex> lock(mutex); return tree.contains(c); }
+
+private:
+    AVLTree<Contact> tree;
+    mutable std::mutex mutex;
+};
+
+template<typename Tree>
+double measure(Tree& tree, const std::vector<Contact>& contacts, int threads) {
+    std::atomic<long> hits(0);
+    std::vector<std::thread> workers;
+    BenchTimer timer;
+
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            long localHits = 0;
+            for (int i = 0; i < OpsPerThread; i++) {
+                const Contact& contact = contacts[rng() % contacts.size()];
+                if (i % 20 == 0) {
+                    // 5% de escritas: remove e devolve o mesmo contato
+                    if (tree.remove(contact)) tree.insert(contact);
+                } else {
+                    localHits += tree.contains(contact);
+                }
+            }
+            hits += localHits;
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    double seconds = timer.elapsedMs() / 1000.0;
+    return threads * (double)OpsPerThread / seconds;
+}
+
+int main(int argc, char** argv) {
+    int n = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int maxThreads = argc > 2 ? std::atoi(argv[2]) 
+                              : (int)std::max(1u, std::thread::hardware_concurrency());
+    auto contacts = benchContacts(n);
+
+    ConcurrentAVLTree<Contact> concurrent;
+    ExclusiveAVLTree exclusive;
+    for (const auto& contact : contacts) {
+        concurrent.insert(contact);
+        exclusive.insert(contact);
+    }
+
+    std::printf("n = %d, %d operações por thread (95%% leitura / 5%% escrita)\n", n, OpsPerThread);
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        double shared = measure(concurrent, contacts, threads);
+        double single = measure(exclusive, contacts, threads);
+        std::printf("  %2d thread(s): shared_mutex %10.0f ops/s | mutex %10.0f ops/s\n",
+                    threads, shared, single);
+    }
+    return 0;
+}
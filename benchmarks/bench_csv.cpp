@@ -0,0 +1,91 @@
+// Exportação e importação de CSV: ofstream campo a campo e getline com
+// stringstream por linha contra CsvWriter/CsvReader (contact_csv.h), em
+// MB/s. A importação completa inclui a inserção em lote na AVL.
+//
+// Compilação:
+//   g++ benchmarks/bench_csv.cpp src/contact.cpp -Iinclude -O2 -std=c++17 -o bench_csv.exe
+// Uso:
+//   ./bench_csv.exe                 (100K e 1M contatos)
+//   ./bench_csv.exe 5000000         (tamanhos escolhidos)
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include "avl_tree.h"
+#include "contact_csv.h"
+#include "bench_utils.h"
+
+int main(int argc, char** argv) {
+    std::string path = (std::filesystem::temp_directory_path() / "agenda_bench.csv").string();
+    std::printf("núcleo: %s\n", CsvScan::kernelName());
+    for (int n : benchSizes(argc, argv, {100000, 1000000})) {
+        std::printf("n = %d\n", n);
+        std::vector<Contact> contacts = benchContacts(n);
+        auto forEach = [&](const auto& visit) {
+            for (const Contact& contact : contacts) visit(contact);
+        };
+
+        // Antes: ofstream << campo a campo, sem aspas
+        BenchTimer timer;
+        {
+            std::ofstream file(path);
+            file << "Nome,Telefone,Email,Favorito\n";
+            for (const Contact& contact : contacts) {
+                file << contact.getName() << "," << contact.getPhone() << "," << contact.getEmail() << ","
+                     << (contact.isFavorite() ? "true" : "false") << "\n";
+            }
+        }
+        double oldExportMs = timer.elapsedMs();
+        double oldMb = std::filesystem::file_size(path) / 1e6;
+
+        timer.reset();
+        std::size_t oldRows = 0;
+        {
+            std::ifstream file(path);
+            std::string line;
+            std::getline(file, line);
+            while (std::getline(file, line)) {
+                std::stringstream ss(line);
+                std::string name, phone, email, favorite;
+                std::getline(ss, name, ',');
+                std::getline(ss, phone, ',');
+                std::getline(ss, email, ',');
+                std::getline(ss, favorite, ',');
+                oldRows += !name.empty();
+            }
+        }
+        double oldParseMs = timer.elapsedMs();
+
+        timer.reset();
+        writeContactsCsv(path, forEach);
+        double exportMs = timer.elapsedMs();
+        double mb = std::filesystem::file_size(path) / 1e6;
+
+        timer.reset();
+        std::size_t fields = 0;
+        {
+            CsvReader reader(path);
+            std::vector<std::string_view> record;
+            while (reader.next(record)) fields += record.size();
+        }
+        double parseMs = timer.elapsedMs();
+
+        timer.reset();
+        CsvImport imported = readContactsCsv(path);
+        double readMs = timer.elapsedMs();
+        AVLTree<Contact> agenda;
+        agenda.insertBulk(std::move(imported.contacts));
+        double importMs = timer.elapsedMs();
+
+        std::printf("  exportar  ofstream   %8.1f ms  %7.1f MB/s\n", oldExportMs, oldMb / oldExportMs * 1e3);
+        std::printf("  exportar  CsvWriter  %8.1f ms  %7.1f MB/s\n", exportMs, mb / exportMs * 1e3);
+        std::printf("  ler       getline    %8.1f ms  %7.1f MB/s (%zu linhas)\n", oldParseMs,
+                    oldMb / oldParseMs * 1e3, oldRows);
+        std::printf("  ler       CsvReader  %8.1f ms  %7.1f MB/s (%zu campos)\n", parseMs, mb / parseMs * 1e3, fields);
+        std::printf("  contatos  CSV        %8.1f ms  %7.1f MB/s\n", readMs, mb / readMs * 1e3);
+        std::printf("  + AVL em lote        %8.1f ms  (%d contatos)\n", importMs, agenda.size());
+    }
+    std::filesystem::remove(path);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+// Busca tolerante a erros: FuzzyIndex (trigramas + distância com corte)
+// contra calcular a distância para todos os contatos.
+//
+// Compilação:
+//   g++ benchmarks/bench_fuzzy.cpp src/contact.cpp -Iinclude -O2 -std=c++17 -o bench_fuzzy.exe
+// Uso:
+//   ./bench_fuzzy.exe            (10K, 100K e 1M contatos)
+//   ./bench_fuzzy.exe 100000 ... (tamanhos escolhidos)
+
+#include <cstdio>
+#include "fuzzy_index.h"
+#include "bench_utils.h"
+
+// Nomes no formato "Nome Sobrenome Sobrenome" a partir de listas comuns
+static std::string personName(int i) {
+    static const char* first[] = {
+        "Ana", "Beatriz", "Bruno", "Camila", "Carlos", "Daniel", "Eduarda", "Fernanda",
+        "Gabriel", "Helena", "Igor", "Juliana", "Lucas", "Mariana", "Pedro", "Rafael",
+        "Sofia", "Thiago", "Vitória", "João", "Larissa", "Gustavo", "Patrícia", "Rodrigo",
+    };
+    static const char* last[] = {
+        "Silva", "Santos", "Oliveira", "Souza", "Lima", "Pereira", "Costa", "Ferreira",
+        "Almeida", "Gomes", "Ribeiro", "Carvalho", "Rocha", "Martins", "Araújo", "Barbosa",
+        "Mendes", "Cardoso", "Teixeira", "Moreira", "Nunes", "Freitas", "Conceição", "Pinto",
+    };
+    const int nf = sizeof(first) / sizeof(*first), nl = sizeof(last) / sizeof(*last);
+    return std::string(first[i % nf]) + " " + last[(i / nf) % nl] + " " + last[(i / nf / nl) % nl] +
+           " " + std::to_string(i / (nf * nl * nl));
+}
+
+int main(int argc, char** argv) {
+    const char* queries[] = {"Beatris Santo", "Mariana Olivera", "Rodirgo Pinto Nunes 17", "conceicao"};
+    for (int n : benchSizes(argc, argv, {10000, 100000, 1000000})) {
+        std::printf("n = %d\n", n);
+        std::vector<std::string> names;
+        for (int i = 0; i < n; i++) names.push_back(personName(i));
+
+        BenchTimer timer;
+        FuzzyIndex index;
+        for (int i = 0; i < n; i++) {
+            index.set(names[i], "contato" + std::to_string(i) + "@email.com");
+        }
+        std::printf("  construção %8.1f ms\n", timer.elapsedMs());
+
+        for (const char* query : queries) {
+            const int repeat = 20;
+            int found = 0;
+            timer.reset();
+            for (int r = 0; r < repeat; r++) {
+                found = index.search(query, 10, [](std::string_view, int) {});
+            }
+            double indexMs = timer.elapsedMs() / repeat;
+
+            // Força bruta: distância limitada contra cada nome
+            timer.reset();
+            int brute = 0;
+            std::string pattern = FoldedCollation::fold(query);
+            for (const std::string& name : names) {
+                std::string folded = FoldedCollation::fold(name);
+                brute += FuzzyIndex::distance(pattern, folded, 2) <= 2;
+            }
+            double bruteMs = timer.elapsedMs();
+
+            std::printf("  %-24s índice %8.3f ms (%d) | força bruta %8.1f ms (%d)\n",
+                        query, indexMs, found, bruteMs, brute);
+        }
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+// Requisições por segundo do servidor web (agenda_web) nos endpoints
+// existentes. Cada cliente é uma thread que envia uma requisição, lê a
+// resposta inteira e repete durante o tempo dado, abrindo uma conexão por
+// requisição ("close") ou reaproveitando a mesma ("keep-alive"); os
+// caminhos e a duração são fixos para as execuções serem comparáveis.
+// Cliente POSIX (Linux).
+//
+// Compilação:
+//   g++ benchmarks/bench_http.cpp src/contact.cpp -Iinclude -O2 -std=c++17 -pthread -o bench_http.exe
+// Uso (com o servidor rodando: ./agenda_web.exe 8080 4 -q):
+//   ./bench_http.exe                 (porta 8080, 32 clientes, 5 s por caminho)
+//   ./bench_http.exe 8080 64 10      (porta, clientes, segundos)
+//   ./bench_http.exe 8080 64 10 close   (só um dos modos: close ou keep-alive)
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include "bench_utils.h"
+
+struct ClientResult {
+    long requests = 0;
+    long errors = 0;
+    std::vector<double> latenciesMs;
+};
+
+// Conexão de um cliente; reaberta quando o servidor fecha
+class Client {
+public:
+    Client(const sockaddr_in& address, bool keepAlive) : address(address), keepAlive(keepAlive) {}
+
+    ~Client() {
+        disconnect();
+    }
+
+    // Uma requisição com resposta 200 completa; false se algo falhar
+    bool request(const std::string& request) {
+        if (fd < 0 && !connectToServer()) return false;
+        if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) != (ssize_t)request.size() ||
+            !readResponse()) {
+            disconnect();
+            return false;
+        }
+        if (!keepAlive || closeRequested) disconnect();
+        return true;
+    }
+
+private:
+    bool connectToServer() {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return false;
+
+        // Fecha com RST, para não esgotar as portas locais em TIME_WAIT
+        linger noLinger{1, 0};
+        setsockopt(fd, SOL_SOCKET, SO_LINGER, &noLinger, sizeof(noLinger));
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        if (connect(fd, (const sockaddr*)&address, sizeof(address)) != 0) {
+            disconnect();
+            return false;
+        }
+        return true;
+    }
+
+    void disconnect() {
+        if (fd >= 0) close(fd);
+        fd = -1;
+    }
+
+    // Cabeçalhos até a linha vazia, depois Content-Length bytes de corpo
+    bool readResponse() {
+        std::string response;
+        char buffer[65536];
+        std::size_t headerEnd = std::string::npos, total = 0;
+        while (headerEnd == std::string::npos || response.size() < total) {
+            ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+            if (n <= 0) return false;
+            response.append(buffer, n);
+            if (headerEnd == std::string::npos && (headerEnd = response.find("\r\n\r\n")) != std::string::npos) {
+                std::size_t length = response.find("Content-Length: ");
+                if (length == std::string::npos || length > headerEnd) return false;
+                total = headerEnd + 4 + std::strtoul(response.c_str() + length + 16, nullptr, 10);
+                closeRequested = response.find("Connection: close") < headerEnd;
+            }
+        }
+        return response.compare(0, 12, "HTTP/1.1 200") == 0;
+    }
+
+    sockaddr_in address;
+    bool keepAlive;
+    bool closeRequested = false;
+    int fd = -1;
+};
+
+// Um caminho, num modo, com clients threads durante seconds segundos
+void runPath(const sockaddr_in& address, const char* path, bool keepAlive, int clients, double seconds) {
+    std::string request = std::string("GET ") + path + " HTTP/1.1\r\nHost: localhost\r\n" +
+                          (keepAlive ? "\r\n" : "Connection: close\r\n\r\n");
+    std::vector<ClientResult> results(clients);
+    std::atomic<bool> running{true};
+    std::vector<std::thread> threads;
+
+    BenchTimer timer;
+    for (int c = 0; c < clients; c++) {
+        threads.emplace_back([&, c] {
+            ClientResult& result = results[c];
+            Client client(address, keepAlive);
+            while (running.load(std::memory_order_relaxed)) {
+                BenchTimer latency;
+                if (client.request(request)) {
+                    result.requests++;
+                    result.latenciesMs.push_back(latency.elapsedMs());
+                } else {
+                    result.errors++;
+                }
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    running = false;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double elapsedMs = timer.elapsedMs();
+
+    long requests = 0, errors = 0;
+    std::vector<double> latencies;
+    for (const auto& result : results) {
+        requests += result.requests;
+        errors += result.errors;
+        latencies.insert(latencies.end(), result.latenciesMs.begin(), result.latenciesMs.end());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+        return latencies.empty() ? 0.0 : latencies[(std::size_t)(p * (latencies.size() - 1))];
+    };
+
+    std::printf("  %-32s %9.0f req/s | p50 %6.2f ms | p99 %6.2f ms | erros %ld\n",
+                path, requests / (elapsedMs / 1000.0), percentile(0.50), percentile(0.99), errors);
+}
+
+int main(int argc, char** argv) {
+    int port = argc > 1 ? std::atoi(argv[1]) : 8080;
+    int clients = argc > 2 ? std::atoi(argv[2]) : 32;
+    double seconds = argc > 3 ? std::atof(argv[3]) : 5.0;
+    std::string only = argc > 4 ? argv[4] : "";
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+
+    const char* paths[] = {
+        "/api/statistics",
+        "/api/search?prefix=a&limit=10",
+        "/api/contacts",
+        "/",
+    };
+    std::printf("porta %d, %d clientes, %.0f s por caminho\n", port, clients, seconds);
+
+    for (bool keepAlive : {false, true}) {
+        const char* mode = keepAlive ? "keep-alive" : "close";
+        if (!only.empty() && only != mode) continue;
+        std::printf("%s\n", mode);
+        for (const char* path : paths) {
+            runPath(address, path, keepAlive, clients, seconds);
+        }
+    }
+    return 0;
+}
\ No newline at end of file
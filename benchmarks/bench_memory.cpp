@@ -0,0 +1,111 @@
+// Memória por contato: Contact compacto (buffer único, campos curtos no
+// próprio objeto) contra o layout anterior com três std::string.
+// Mede os bytes e alocações vivos depois de montar a árvore, contados no
+// operator new, então o resultado não depende do sistema; o overhead do
+// malloc por alocação fica de fora (e só favorece quem aloca mais).
+//
+// Compilação:
+//   g++ benchmarks/bench_memory.cpp src/contact.cpp -Iinclude -O2 -std=c++17 -o bench_memory.exe
+// Uso:
+//   ./bench_memory.exe            (1M e 10M contatos)
+//   ./bench_memory.exe 100000 ... (tamanhos escolhidos)
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include "avl_tree.h"
+#include "bench_utils.h"
+
+static std::size_t liveBytes = 0;
+static std::size_t liveAllocations = 0;
+
+// Cada bloco guarda o próprio tamanho em um cabeçalho
+static constexpr std::size_t HeaderSize = alignof(std::max_align_t);
+
+// Sem inlining o GCC não confunde o cabeçalho com acesso fora do objeto
+#ifdef __GNUC__
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+BENCH_NOINLINE void* operator new(std::size_t size) {
+    char* block = static_cast<char*>(std::malloc(size + HeaderSize));
+    if (!block) throw std::bad_alloc();
+    *reinterpret_cast<std::size_t*>(block) = size;
+    liveBytes += size;
+    liveAllocations++;
+    return block + HeaderSize;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+BENCH_NOINLINE void operator delete(void* p) noexcept {
+    if (!p) return;
+    char* block = static_cast<char*>(p) - HeaderSize;
+    liveBytes -= *reinterpret_cast<std::size_t*>(block);
+    liveAllocations--;
+    std::free(block);
+}
+
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, std::size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, std::size_t) noexcept { operator delete(p); }
+
+// Layout anterior do contato, só para comparação
+struct LegacyContact {
+    std::string name;
+    std::string phone;
+    std::string email;
+    bool favorite;
+
+    bool operator<(const LegacyContact& other) const {
+        return name < other.name;
+    }
+};
+
+template<typename Tree, typename Make>
+void measure(const char* label, int n, Make make) {
+    std::size_t bytesBefore = liveBytes;
+    std::size_t countBefore = liveAllocations;
+    BenchTimer timer;
+
+    {
+        auto* tree = new Tree();
+        for (int i = 0; i < n; i++) {
+            tree->insert(make(i));
+        }
+        double insertMs = timer.elapsedMs();
+
+        double bytes = double(liveBytes - bytesBefore) / n;
+        double allocations = double(liveAllocations - countBefore) / n;
+        std::printf("  %-22s %7.1f bytes/contato | %5.2f alocações/contato | inserção %9.1f ms\n",
+                    label, bytes, allocations, insertMs);
+        delete tree;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::printf("sizeof(Contact) = %zu, sizeof(LegacyContact) = %zu\n",
+                sizeof(Contact), sizeof(LegacyContact));
+
+    for (int n : benchSizes(argc, argv, {1000000, 10000000})) {
+        std::printf("n = %d\n", n);
+        // Os contatos são gerados na hora para que só a árvore seja contada
+        auto makeCompact = [](int i) {
+            return Contact(benchName(i), "11-9999-9999",
+                           "contato" + std::to_string(i) + "@email.com", i % 5 == 0);
+        };
+        auto makeLegacy = [](int i) {
+            return LegacyContact{benchName(i), "11-9999-9999",
+                                 "contato" + std::to_string(i) + "@email.com", i % 5 == 0};
+        };
+        measure<AVLTree<LegacyContact>>("std::string (heap)", n, makeLegacy);
+        measure<AVLTree<Contact>>("compacto (heap)", n, makeCompact);
+        measure<AVLTree<Contact, PoolNodeAllocator>>("compacto (pool)", n, makeCompact);
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+// Mescla duas agendas: inserções uma a uma x união/diferença/interseção por
+// join/split, variando o número de threads do pool.
+//
+// Compilação:
+//   g++ benchmarks/bench_set_operations.cpp src/contact.cpp -Iinclude -O2 -std=c++17 -pthread -o bench_set_operations.exe
+// Uso:
+//   ./bench_set_operations.exe            (duas agendas de 1M)
+//   ./bench_set_operations.exe 100000 ... (tamanhos escolhidos)
+
+#include <cstdio>
+#include <thread>
+#include "avl_tree.h"
+#include "bench_utils.h"
+
+// Metade dos contatos de b também está em a
+static void makeAgendas(int n, AVLTree<Contact>& a, AVLTree<Contact>& b) {
+    auto contacts = benchContacts(n + n / 2);
+    a.assignBulk(std::vector<Contact>(contacts.begin(), contacts.begin() + n));
+    b.assignBulk(std::vector<Contact>(contacts.begin() + n / 2, contacts.end()));
+}
+
+static AVLTree<Contact> copyOf(const AVLTree<Contact>& tree) {
+    AVLTree<Contact> copy;
+    copy.buildFromSorted(tree.begin(), tree.end());
+    return copy;
+}
+
+int main(int argc, char** argv) {
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int n : benchSizes(argc, argv, {1000000})) {
+        AVLTree<Contact> a, b;
+        makeAgendas(n, a, b);
+        std::printf("n = %d (|a| = %d, |b| = %d)\n", n, a.size(), b.size());
+
+        {
+            AVLTree<Contact> target = copyOf(a);
+            BenchTimer timer;
+            for (const Contact& contact : b) {
+                target.insert(contact);
+            }
+            std::printf("  inserções uma a uma          %9.1f ms (resultado %d)\n",
+                        timer.elapsedMs(), target.size());
+        }
+
+        for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+            ForkJoinPool pool(threads - 1);
+            AVLTree<Contact> unionTree = copyOf(a);
+            AVLTree<Contact> diffTree = copyOf(a);
+            AVLTree<Contact> interTree = copyOf(a);
+
+            BenchTimer timer;
+            unionTree.unionWith(b, pool);
+            double unionMs = timer.elapsedMs();
+
+            timer.reset();
+            diffTree.difference(b, pool);
+            double diffMs = timer.elapsedMs();
+
+            timer.reset();
+            interTree.intersection(b, pool);
+            double interMs = timer.elapsedMs();
+
+            std::printf("  %2u thread(s): união %9.1f ms | diferença %9.1f ms | interseção %9.1f ms\n",
+                        threads, unionMs, diffMs, interMs);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Partida da agenda: CSV lido linha a linha com inserção um a um contra o
+// snapshot binário mapeado (contact_snapshot.h) montado em O(n), com e sem
+// a ordem dos índices gravada.
+//
+// Compilação:
+//   g++ benchmarks/bench_snapshot.cpp src/contact.cpp -Iinclude -O2 -std=c++17 -pthread -o bench_snapshot.exe
+// Uso:
+//   ./bench_snapshot.exe            (100K e 1M contatos)
+//   ./bench_snapshot.exe 5000000    (tamanhos escolhidos)
+
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+#include "contact_journal.h"
+#include "contact_snapshot.h"
+#include "contact_store.h"
+#include "bench_utils.h"
+
+int main(int argc, char** argv) {
+    std::string directory = (std::filesystem::temp_directory_path() / "agenda_bench_snapshot").string();
+    for (int n : benchSizes(argc, argv, {100000, 1000000})) {
+        std::printf("n = %d\n", n);
+        std::vector<Contact> contacts = benchContacts(n);
+        std::sort(contacts.begin(), contacts.end());
+
+        ContactStore<> source;
+        std::size_t built = 0;
+        source.assignSorted(n, [&] { return contacts[built++]; });
+
+        // Antes: CSV em memória, getline/stringstream e uma inserção por linha
+        std::string csv = "Nome,Telefone,Email,Favorito\n";
+        for (const Contact& contact : contacts) {
+            csv.append(contact.getName()).append(",").append(contact.getPhone()).append(",");
+            csv.append(contact.getEmail()).append(contact.isFavorite() ? ",true\n" : ",false\n");
+        }
+        BenchTimer timer;
+        {
+            ContactStore<> store;
+            std::istringstream file(csv);
+            std::string line;
+            std::getline(file, line);
+            while (std::getline(file, line)) {
+                std::stringstream ss(line);
+                std::string name, phone, email, favorite;
+                std::getline(ss, name, ',');
+                std::getline(ss, phone, ',');
+                std::getline(ss, email, ',');
+                std::getline(ss, favorite, ',');
+                store.insert(Contact(name, phone, email, favorite == "true"));
+            }
+            std::printf("  CSV + inserções    %9.1f ms\n", timer.elapsedMs());
+        }
+
+        // Snapshot gravado pelo checkpoint do log, como no servidor
+        std::filesystem::remove_all(directory);
+        {
+            ContactJournal journal(directory);
+            journal.recover([](const Contact&) {}, [](std::string_view) {});
+            journal.open();
+            timer.reset();
+            journal.checkpoint([&](ContactSnapshot::Writer& writer) { source.snapshot().writeTo(writer); });
+            std::printf("  gravar snapshot    %9.1f ms (%.1f MB)\n", timer.elapsedMs(),
+                        std::filesystem::file_size(directory + "/agenda.snapshot") / 1e6);
+        }
+
+        timer.reset();
+        ContactSnapshot snapshot;
+        snapshot.open(directory + "/agenda.snapshot");
+        std::printf("  mmap + checksum    %9.1f ms\n", timer.elapsedMs());
+        {
+            ContactStore<> store;
+            bool sorted = store.assign(snapshot);
+            std::printf("  árvores (ordens)   %9.1f ms (%d contatos%s)\n", timer.elapsedMs(), store.snapshot().size(),
+                        sorted ? "" : ", FORA DE ORDEM");
+        }
+        {
+            timer.reset();
+            ContactStore<> store;
+            std::size_t next = 0;
+            store.assignSorted((int)snapshot.size(), [&] { return snapshot[next++].toContact(); });
+            std::printf("  árvores (ordenar)  %9.1f ms\n", timer.elapsedMs());
+        }
+    }
+    std::filesystem::remove_all(directory);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+// Busca por trecho: núcleos de SubstringScan (escalar, SSE2, AVX2) contra
+// std::string_view::find num buffer de nomes dobrados, e a busca completa
+// do ContactScanIndex contra percorrer a árvore dobrando cada contato.
+//
+// Compilação:
+//   g++ benchmarks/bench_substring.cpp src/contact.cpp -Iinclude -O2 -std=c++17 -o bench_substring.exe
+//   (acrescente -mavx2 para o núcleo AVX2)
+// Uso:
+//   ./bench_substring.exe            (10K, 1M e 10M contatos)
+//   ./bench_substring.exe 100000 ... (tamanhos escolhidos)
+
+#include <cstdio>
+#include "avl_tree.h"
+#include "contact_scan.h"
+#include "bench_utils.h"
+
+// Ocorrências de pattern em text usando o núcleo dado
+template<typename Kernel>
+void timeKernel(const char* label, const std::string& text, const std::string& pattern, Kernel kernel) {
+    BenchTimer timer;
+    long hits = 0;
+    std::size_t pos = kernel(text, pattern, 0);
+    while (pos != std::string_view::npos) {
+        hits++;
+        pos = kernel(text, pattern, pos + 1);
+    }
+    double ms = timer.elapsedMs();
+    std::printf("    %-8s %8.2f ms (%6.2f GB/s) %ld ocorrências\n",
+                label, ms, text.size() / ms / 1e6, hits);
+}
+
+int main(int argc, char** argv) {
+    std::printf("núcleo padrão: %s\n", SubstringScan::kernelName());
+    for (int n : benchSizes(argc, argv, {10000, 1000000, 10000000})) {
+        std::printf("n = %d\n", n);
+        auto* tree = new AVLTree<Contact>();
+        for (const auto& contact : benchContacts(n)) {
+            tree->insert(contact);
+        }
+
+        // Coluna de nomes como a do índice: dobrada e separada por '\0'
+        std::string names;
+        tree->forEach([&](const Contact& c) {
+            names += ContactScanIndex::fold(c.getName());
+            names += '\0';
+        });
+
+        // Trecho raro (um contato) e frequente (um a cada mil)
+        for (std::string pattern : {benchName(n / 2).substr(4), std::string("0123")}) {
+            pattern = ContactScanIndex::fold(pattern);
+            std::printf("  \"%s\" em %.1f MB de nomes\n", pattern.c_str(), names.size() / 1e6);
+            timeKernel("find", names, pattern, [](std::string_view t, std::string_view p, std::size_t from) {
+                return t.find(p, from);
+            });
+            timeKernel("escalar", names, pattern, SubstringScan::scalar);
+#ifdef CONTACT_SCAN_SSE2
+            timeKernel("sse2", names, pattern, SubstringScan::sse2);
+#endif
+#ifdef CONTACT_SCAN_AVX2
+            timeKernel("avx2", names, pattern, SubstringScan::avx2);
+#endif
+        }
+
+        BenchTimer timer;
+        ContactScanIndex index(*tree);
+        double buildMs = timer.elapsedMs();
+
+        // Busca completa (nome, telefone e email) por um trecho raro
+        std::string query = benchName(n / 3).substr(8);
+        timer.reset();
+        int indexed = index.search(query, [](const Contact&) {});
+        double indexMs = timer.elapsedMs();
+
+        timer.reset();
+        std::string folded = ContactScanIndex::fold(query);
+        int walked = 0;
+        tree->forEach([&](const Contact& c) {
+            if (ContactScanIndex::fold(c.getName()).find(folded) != std::string::npos ||
+                ContactScanIndex::fold(c.getPhone()).find(folded) != std::string::npos ||
+                ContactScanIndex::fold(c.getEmail()).find(folded) != std::string::npos) {
+                walked++;
+            }
+        });
+        double walkMs = timer.elapsedMs();
+
+        std::printf("  índice: construção %8.1f ms | busca %8.2f ms (%d) | árvore %8.1f ms (%d)\n",
+                    buildMs, indexMs, indexed, walkMs, walked);
+        delete tree;
+    }
+    return 0;
+}
\ No newline at end of file
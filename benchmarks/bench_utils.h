@@ -0,0 +1,60 @@
+#ifndef BENCH_UTILS_H
+#define BENCH_UTILS_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "contact.h"
+
+// Cronômetro simples em milissegundos
+class BenchTimer {
+public:
+    BenchTimer() : start(std::chrono::steady_clock::now()) {}
+
+    double elapsedMs() const {
+        auto now = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(now - start).count();
+    }
+
+    void reset() {
+        start = std::chrono::steady_clock::now();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+// Nome determinístico para o i-ésimo contato de teste
+inline std::string benchName(int i) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "Contato %08d", i);
+    return buffer;
+}
+
+// Contatos de 0 a n-1 em ordem aleatória (semente fixa para reprodutibilidade)
+inline std::vector<Contact> benchContacts(int n, unsigned seed = 42) {
+    std::vector<Contact> contacts;
+    contacts.reserve(n);
+    for (int i = 0; i < n; i++) {
+        contacts.emplace_back(benchName(i), "11-9999-9999", 
+                              "contato" + std::to_string(i) + "@email.com", i % 5 == 0);
+    }
+    std::shuffle(contacts.begin(), contacts.end(), std::mt19937(seed));
+    return contacts;
+}
+
+// Tamanhos passados na linha de comando, ou os padrões informados
+inline std::vector<int> benchSizes(int argc, char** argv, std::vector<int> defaults) {
+    if (argc <= 1) return defaults;
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++) {
+        sizes.push_back(std::atoi(argv[i]));
+    }
+    return sizes;
+}
+
+#endif
@@ -5,13 +5,13 @@ echo    COMPILADOR AGENDA AVL - CONSOLE
 echo ========================================
 
 echo Compilando contato.cpp...
-g++ -c src/contact.cpp -Iinclude -std=c++17 -o contact.o
+g++ -c src/contact.cpp -Iinclude -std=c++17 -pthread -o contact.o
 
 echo Compilando programa principal...
-g++ -c src/main_console.cpp -Iinclude -std=c++17 -o main_console.o
+g++ -c src/main_console.cpp -Iinclude -std=c++17 -pthread -o main_console.o
 
 echo Linkando executável...
-g++ main_console.o contact.o -o agenda_avl.exe
+g++ main_console.o contact.o -pthread -o agenda_avl.exe
 
 if %errorlevel% equ 0 (
     echo.
@@ -5,7 +5,7 @@ echo    COMPILADOR AGENDA AVL - WEB
 echo ========================================
 
 echo Compilando contact.cpp...
-g++ -c src\contact.cpp -Iinclude -std=c++17 -o contact.o
+g++ -c src\contact.cpp -Iinclude -O2 -std=c++17 -pthread -o contact.o
 
 if %errorlevel% neq 0 (
     echo ERRO: Falha ao compilar contact.cpp
@@ -13,7 +13,7 @@ if %errorlevel% neq 0 (
 )
 
 echo Compilando servidor web...
-g++ -c src\simple_server.cpp -Iinclude -std=c++17 -o server.o
+g++ -c src\simple_server.cpp -Iinclude -O2 -std=c++17 -pthread -o server.o
 
 if %errorlevel% neq 0 (
     echo ERRO: Falha ao compilar server.cpp
@@ -21,13 +21,13 @@ if %errorlevel% neq 0 (
 )
 
 echo Linkando servidor...
-g++ server.o contact.o -o agenda_web.exe -lws2_32
+g++ server.o contact.o -pthread -o agenda_web.exe -lws2_32
 
 if %errorlevel% equ 0 (
     echo.
     echo COMPILACAO BEM-SUCEDIDA!
     echo.
-    echo Execute: agenda_web.exe
+    echo Execute: agenda_web.exe [porta]
     echo Acesse: http://localhost:8080
     echo.
 ) else (
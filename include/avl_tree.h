@@ -2,224 +2,863 @@
 #define AVL_TREE_H
 
 #include "contact.h"
+#include "node_allocator.h"
+#include "node_marker.h"
+#include "update_view.h"
+#include "fork_join_pool.h"
 #include <vector>
 #include <memory>
 #include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <cstddef>
+#include <type_traits>
+#include <functional>
 
-template<typename T>
+// Alloc define onde os nós vivem: HeapNodeAllocator (um new por nó) ou
+// PoolNodeAllocator (blocos contíguos com reaproveitamento de nós).
+// Compare define a ordem (padrão: operator<); deve ser um tipo sem estado,
+// como as colações de collation.h. Marker define quais elementos são
+// contados em cada subárvore (para Contact, os favoritos; ver node_marker.h).
+template<typename T, template<typename> class Alloc = HeapNodeAllocator,
+         typename Compare = std::less<T>, typename Marker = DefaultMarker<T>>
 class AVLTree {
 private:
     struct Node {
         T data;
-        std::unique_ptr<Node> left;
-        std::unique_ptr<Node> right;
+        Node* left;
+        Node* right;
         int height;
+        int count;  // Quantidade de nós na subárvore
+        int marked; // Quantos desses satisfazem Marker
         
-        Node(const T& value) : data(value), height(1) {}
+        Node(const T& value) 
+            : data(value), left(nullptr), right(nullptr), height(1), count(1),
+              marked(isMarked(data)) {}
+        
+        Node(T&& value) 
+            : data(std::move(value)), left(nullptr), right(nullptr), height(1), count(1),
+              marked(isMarked(data)) {}
     };
     
-    std::unique_ptr<Node> root;
+    // Altura máxima de uma AVL com até 2^31 nós é 45
+    static constexpr int MaxDepth = 64;
+    
+    Node* root = nullptr;
+    Alloc<Node> allocator;
     
     // Métodos auxiliares
+    static bool lessThan(const T& a, const T& b) {
+        return Compare()(a, b);
+    }
+    
+    static int isMarked(const T& value) {
+        return Marker::marked(value) ? 1 : 0;
+    }
+    
     int height(const Node* node) const {
         return node ? node->height : 0;
     }
     
+    int count(const Node* node) const {
+        return node ? node->count : 0;
+    }
+    
+    int marked(const Node* node) const {
+        return node ? node->marked : 0;
+    }
+    
     int balanceFactor(const Node* node) const {
-        return node ? height(node->left.get()) - height(node->right.get()) : 0;
+        return node ? height(node->left) - height(node->right) : 0;
     }
     
-    void updateHeight(Node* node) {
+    // Atualiza altura, tamanho e marcados da subárvore a partir dos filhos
+    void updateNode(Node* node) {
         if (node) {
-            node->height = std::max(height(node->left.get()), 
-                                   height(node->right.get())) + 1;
+            node->height = std::max(height(node->left), 
+                                   height(node->right)) + 1;
+            node->count = count(node->left) + count(node->right) + 1;
+            node->marked = marked(node->left) + marked(node->right) + isMarked(node->data);
         }
     }
     
     // Rotações
-    std::unique_ptr<Node> rotateRight(std::unique_ptr<Node> y) {
-        auto x = std::move(y->left);
-        y->left = std::move(x->right);
-        x->right = std::move(y);
+    Node* rotateRight(Node* y) {
+        Node* x = y->left;
+        y->left = x->right;
+        x->right = y;
         
-        updateHeight(x->right.get());
-        updateHeight(x.get());
+        updateNode(y);
+        updateNode(x);
         
         return x;
     }
     
-    std::unique_ptr<Node> rotateLeft(std::unique_ptr<Node> x) {
-        auto y = std::move(x->right);
-        x->right = std::move(y->left);
-        y->left = std::move(x);
+    Node* rotateLeft(Node* x) {
+        Node* y = x->right;
+        x->right = y->left;
+        y->left = x;
         
-        updateHeight(y->left.get());
-        updateHeight(y.get());
+        updateNode(x);
+        updateNode(y);
         
         return y;
     }
     
-    std::unique_ptr<Node> balance(std::unique_ptr<Node> node) {
-        updateHeight(node.get());
-        int bf = balanceFactor(node.get());
+    Node* balance(Node* node) {
+        updateNode(node);
+        int bf = balanceFactor(node);
         
         // Caso Left-Left
-        if (bf > 1 && balanceFactor(node->left.get()) >= 0) {
-            return rotateRight(std::move(node));
+        if (bf > 1 && balanceFactor(node->left) >= 0) {
+            return rotateRight(node);
         }
         
         // Caso Right-Right
-        if (bf < -1 && balanceFactor(node->right.get()) <= 0) {
-            return rotateLeft(std::move(node));
+        if (bf < -1 && balanceFactor(node->right) <= 0) {
+            return rotateLeft(node);
         }
         
         // Caso Left-Right
-        if (bf > 1 && balanceFactor(node->left.get()) < 0) {
-            node->left = rotateLeft(std::move(node->left));
-            return rotateRight(std::move(node));
+        if (bf > 1 && balanceFactor(node->left) < 0) {
+            node->left = rotateLeft(node->left);
+            return rotateRight(node);
         }
         
         // Caso Right-Left
-        if (bf < -1 && balanceFactor(node->right.get()) > 0) {
-            node->right = rotateRight(std::move(node->right));
-            return rotateLeft(std::move(node));
+        if (bf < -1 && balanceFactor(node->right) > 0) {
+            node->right = rotateRight(node->right);
+            return rotateLeft(node);
         }
         
         return node;
     }
     
-    // Inserção recursiva
-    std::unique_ptr<Node> insertRec(std::unique_ptr<Node> node, const T& value) {
-        if (!node) {
-            return std::make_unique<Node>(value);
+    // Sobe pelo caminho registrado rebalanceando. Assim que a altura de uma
+    // subárvore não muda, os ancestrais também não mudam de forma: daí em
+    // diante só o tamanho e os marcados das subárvores são recalculados.
+    // (Na remoção com sucessor, os nós abaixo e acima do removido perdem
+    // elementos diferentes, então não basta somar um delta fixo.)
+    void retrace(Node** path[], int depth) {
+        while (depth > 0) {
+            Node** link = path[--depth];
+            int oldHeight = (*link)->height;
+            *link = balance(*link);
+            if ((*link)->height == oldHeight) break;
         }
-        
-        if (value < node->data) {
-            node->left = insertRec(std::move(node->left), value);
-        } else if (value > node->data) {
-            node->right = insertRec(std::move(node->right), value);
-        } else {
-            return node; // Duplicado
+        while (depth > 0) {
+            updateNode(*path[--depth]);
         }
-        
-        return balance(std::move(node));
     }
     
-    // Encontrar mínimo
-    Node* findMin(Node* node) const {
-        while (node && node->left) {
-            node = node->left.get();
+    // Busca iterativa
+    Node* findNode(const T& value) const {
+        Node* node = root;
+        while (node) {
+            if (lessThan(value, node->data)) {
+                node = node->left;
+            } else if (lessThan(node->data, value)) {
+                node = node->right;
+            } else {
+                return node;
+            }
         }
-        return node;
+        return nullptr;
     }
     
-    // Remoção recursiva
-    std::unique_ptr<Node> removeRec(std::unique_ptr<Node> node, const T& value) {
-        if (!node) return nullptr;
-        
-        if (value < node->data) {
-            node->left = removeRec(std::move(node->left), value);
-        } else if (value > node->data) {
-            node->right = removeRec(std::move(node->right), value);
-        } else {
-            if (!node->left || !node->right) {
-                node = std::move(node->left ? node->left : node->right);
+    // Aplica change ao elemento equivalente a key e recalcula os marcados
+    // do caminho até ele. change não pode alterar a posição do elemento.
+    template<typename Change>
+    bool updateInPlace(const T& key, Change change) {
+        Node* path[MaxDepth];
+        int depth = 0;
+        Node* node = root;
+        while (node) {
+            path[depth++] = node;
+            if (lessThan(key, node->data)) {
+                node = node->left;
+            } else if (lessThan(node->data, key)) {
+                node = node->right;
             } else {
-                Node* minNode = findMin(node->right.get());
-                node->data = minNode->data;
-                node->right = removeRec(std::move(node->right), minNode->data);
+                break;
             }
         }
+        if (!node) return false;
         
-        if (!node) return nullptr;
-        return balance(std::move(node));
-    }
-    
-    // Busca recursiva
-    Node* searchRec(Node* node, const T& value) const {
-        if (!node) return nullptr;
-        
-        if (value < node->data) {
-            return searchRec(node->left.get(), value);
-        } else if (value > node->data) {
-            return searchRec(node->right.get(), value);
-        } else {
-            return node;
+        int wasMarked = node->marked;
+        change(node->data);
+        updateNode(node);
+        if (node->marked != wasMarked) {
+            while (--depth > 0) {
+                updateNode(path[depth - 1]);
+            }
         }
+        return true;
     }
     
     // Travessias
-    void inOrderRec(Node* node, std::vector<T>& result) const {
+    template<typename Visitor>
+    void forEachRec(const Node* node, Visitor& visit) const {
         if (!node) return;
         
-        inOrderRec(node->left.get(), result);
-        result.push_back(node->data);
-        inOrderRec(node->right.get(), result);
+        forEachRec(node->left, visit);
+        visit(node->data);
+        forEachRec(node->right, visit);
     }
     
-    void collectFavoritesRec(Node* node, std::vector<T>& result) const {
-        if (!node) return;
+    // Visita em ordem só os elementos marcados, pulando subárvores sem nenhum
+    template<typename Visitor>
+    void forEachMarkedRec(const Node* node, Visitor& visit) const {
+        if (!node || node->marked == 0) return;
         
-        collectFavoritesRec(node->left.get(), result);
-        if (node->data.isFavorite()) {
-            result.push_back(node->data);
+        forEachMarkedRec(node->left, visit);
+        if (isMarked(node->data)) visit(node->data);
+        forEachMarkedRec(node->right, visit);
+    }
+    
+    // Estatística de ordem
+    Node* selectNode(Node* node, int k) const {
+        while (node) {
+            int leftCount = count(node->left);
+            if (k < leftCount) {
+                node = node->left;
+            } else if (k > leftCount) {
+                k -= leftCount + 1;
+                node = node->right;
+            } else {
+                return node;
+            }
         }
-        collectFavoritesRec(node->right.get(), result);
+        return nullptr;
     }
     
-    // Verificação de balanceamento
+    // Verificação de balanceamento (inclui altura, tamanho e marcados
+    // armazenados, já que a inserção/remoção iterativa interrompe a subida
+    // mais cedo)
     bool isBalancedRec(Node* node) const {
         if (!node) return true;
         
         int bf = std::abs(balanceFactor(node));
         return bf <= 1 && 
-               isBalancedRec(node->left.get()) && 
-               isBalancedRec(node->right.get());
+               node->height == std::max(height(node->left), height(node->right)) + 1 &&
+               node->count == count(node->left) + count(node->right) + 1 &&
+               node->marked == marked(node->left) + marked(node->right) + isMarked(node->data) &&
+               isBalancedRec(node->left) && 
+               isBalancedRec(node->right);
+    }
+    
+    // Construção balanceada consumindo n elementos ordenados de next, em
+    // ordem: metade vai para a esquerda, o seguinte vira a raiz e o resto vai
+    // para a direita, então as alturas diferem no máximo em 1
+    template<typename Iterator>
+    Node* buildRec(Iterator& next, std::ptrdiff_t n) {
+        if (n <= 0) return nullptr;
+        
+        Node* left = buildRec(next, n / 2);
+        Node* node = allocator.create(*next);
+        ++next;
+        node->left = left;
+        node->right = buildRec(next, n - n / 2 - 1);
+        updateNode(node);
+        return node;
+    }
+    
+    // Ordena de forma estável e remove duplicados, mantendo a primeira ocorrência
+    static void sortUnique(std::vector<T>& values) {
+        std::stable_sort(values.begin(), values.end(), lessThan);
+        values.erase(std::unique(values.begin(), values.end(),
+                                 [](const T& a, const T& b) { return !lessThan(a, b) && !lessThan(b, a); }),
+                     values.end());
+    }
+    
+    // Libera uma subárvore sem recursão: rotaciona os filhos esquerdos até
+    // formar uma lista encadeada pela direita e destrói nó a nó
+    void destroySubtree(Node* node) {
+        while (node) {
+            if (node->left) {
+                Node* left = node->left;
+                node->left = left->right;
+                left->right = node;
+                node = left;
+            } else {
+                Node* right = node->right;
+                allocator.destroy(node);
+                node = right;
+            }
+        }
+    }
+    
+    // Libera todos os nós. Quando os dados não precisam de destrutor e o
+    // alocador libera em bloco, o custo cai para O(blocos).
+    void destroyAll() {
+        if (!(std::is_trivially_destructible<T>::value && 
+              Alloc<Node>::releasesInBulk)) {
+            destroySubtree(root);
+        }
+        allocator.releaseAll();
+        root = nullptr;
+    }
+    
+    Node* cloneRec(const Node* node) {
+        if (!node) return nullptr;
+        
+        Node* copy = allocator.create(node->data);
+        copy->left = cloneRec(node->left);
+        copy->right = cloneRec(node->right);
+        copy->height = node->height;
+        copy->count = node->count;
+        copy->marked = node->marked;
+        return copy;
+    }
+    
+    // Alocadores sem estado (heap) permitem mover nós entre árvores; com
+    // estado (pool), os nós da outra árvore são copiados para este alocador
+    Node* adoptNodes(AVLTree& other) {
+        Node* nodes = other.root;
+        if (std::is_empty<Alloc<Node>>::value) {
+            other.root = nullptr;
+        } else {
+            nodes = cloneRec(other.root);
+            other.clear();
+        }
+        return nodes;
+    }
+    
+    // Join/split: base das operações de conjunto
+    
+    static Node* detach(Node* node) {
+        node->left = node->right = nullptr;
+        node->height = node->count = 1;
+        node->marked = isMarked(node->data);
+        return node;
+    }
+    
+    // Une left < key < right, descendo pela espinha da árvore mais alta até
+    // encontrar uma subárvore de altura compatível com a outra
+    Node* join(Node* left, Node* key, Node* right) {
+        if (height(left) > height(right) + 1) {
+            left->right = join(left->right, key, right);
+            return balance(left);
+        }
+        if (height(right) > height(left) + 1) {
+            right->left = join(left, key, right->left);
+            return balance(right);
+        }
+        key->left = left;
+        key->right = right;
+        updateNode(key);
+        return key;
+    }
+    
+    // Remove o maior elemento da subárvore, devolvendo-o em last
+    Node* splitLast(Node* node, Node*& last) {
+        if (!node->right) {
+            Node* left = node->left;
+            last = detach(node);
+            return left;
+        }
+        node->right = splitLast(node->right, last);
+        return balance(node);
+    }
+    
+    // Une left < right sem chave intermediária
+    Node* join2(Node* left, Node* right) {
+        if (!left) return right;
+        Node* last;
+        left = splitLast(left, last);
+        return join(left, last, right);
+    }
+    
+    // Divide a subárvore em menores e maiores que value; o nó igual (se
+    // existir) é devolvido isolado
+    Node* split(Node* node, const T& value, Node*& less, Node*& greater) {
+        if (!node) {
+            less = greater = nullptr;
+            return nullptr;
+        }
+        
+        Node* left = node->left;
+        Node* right = node->right;
+        if (lessThan(value, node->data)) {
+            Node* found = split(left, value, less, greater);
+            greater = join(greater, detach(node), right);
+            return found;
+        }
+        if (lessThan(node->data, value)) {
+            Node* found = split(right, value, less, greater);
+            less = join(left, detach(node), less);
+            return found;
+        }
+        less = left;
+        greater = right;
+        return detach(node);
+    }
+    
+    // Subproblemas menores que isso rodam em sequência
+    static constexpr int ParallelThreshold = 4096;
+    
+    // Executa as duas metades em paralelo quando compensa. Nós descartados
+    // vão para garbage e só são liberados depois, na thread chamadora, pois
+    // o alocador não é thread-safe.
+    template<typename LeftHalf, typename RightHalf>
+    void forkJoin(ForkJoinPool& pool, int work, std::vector<Node*>& garbage,
+                  LeftHalf leftHalf, RightHalf rightHalf) {
+        if (work < ParallelThreshold) {
+            leftHalf(garbage);
+            rightHalf(garbage);
+            return;
+        }
+        std::vector<Node*> rightGarbage;
+        pool.invoke([&] { leftHalf(garbage); },
+                    [&] { rightHalf(rightGarbage); });
+        garbage.insert(garbage.end(), rightGarbage.begin(), rightGarbage.end());
+    }
+    
+    // União destrutiva de a e b; em chaves repetidas vence o nó de a
+    Node* unionRec(Node* a, Node* b, ForkJoinPool& pool, std::vector<Node*>& garbage) {
+        if (!a) return b;
+        if (!b) return a;
+        
+        int work = a->count + b->count;
+        Node* less;
+        Node* greater;
+        Node* duplicate = split(b, a->data, less, greater);
+        if (duplicate) garbage.push_back(duplicate);
+        
+        Node* left = a->left;
+        Node* right = a->right;
+        forkJoin(pool, work, garbage,
+            [&](std::vector<Node*>& g) { left = unionRec(left, less, pool, g); },
+            [&](std::vector<Node*>& g) { right = unionRec(right, greater, pool, g); });
+        return join(left, detach(a), right);
+    }
+    
+    // Remove de a os elementos presentes em b (b só é lido)
+    Node* differenceRec(Node* a, const Node* b, ForkJoinPool& pool, std::vector<Node*>& garbage) {
+        if (!a || !b) return a;
+        
+        int work = a->count + b->count;
+        Node* less;
+        Node* greater;
+        Node* found = split(a, b->data, less, greater);
+        if (found) garbage.push_back(found);
+        
+        forkJoin(pool, work, garbage,
+            [&](std::vector<Node*>& g) { less = differenceRec(less, b->left, pool, g); },
+            [&](std::vector<Node*>& g) { greater = differenceRec(greater, b->right, pool, g); });
+        return join2(less, greater);
+    }
+    
+    // Mantém em a apenas os elementos presentes em b (b só é lido)
+    Node* intersectionRec(Node* a, const Node* b, ForkJoinPool& pool, std::vector<Node*>& garbage) {
+        if (!a) return nullptr;
+        if (!b) {
+            garbage.push_back(a);
+            return nullptr;
+        }
+        
+        int work = a->count + b->count;
+        Node* less;
+        Node* greater;
+        Node* found = split(a, b->data, less, greater);
+        
+        forkJoin(pool, work, garbage,
+            [&](std::vector<Node*>& g) { less = intersectionRec(less, b->left, pool, g); },
+            [&](std::vector<Node*>& g) { greater = intersectionRec(greater, b->right, pool, g); });
+        return found ? join(less, found, greater) : join2(less, greater);
+    }
+    
+    void collectGarbage(std::vector<Node*>& garbage) {
+        for (Node* node : garbage) {
+            destroySubtree(node);
+        }
     }
     
 public:
+    // Iterador bidirecional in-order. Guarda o caminho desde a raiz em um
+    // vetor fixo (altura AVL < 64 para qualquer n representável em int),
+    // então percorrer a árvore não faz nenhuma alocação.
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+        
+        const_iterator() = default;
+        
+        reference operator*() const { return path[depth - 1]->data; }
+        pointer operator->() const { return &path[depth - 1]->data; }
+        
+        const_iterator& operator++() {
+            const Node* node = path[depth - 1];
+            if (node->right) {
+                pushLeftSpine(node->right);
+            } else {
+                popWhileFrom(false);
+            }
+            return *this;
+        }
+        
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+        
+        const_iterator& operator--() {
+            if (depth == 0) {
+                pushRightSpine(tree->root);
+            } else if (path[depth - 1]->left) {
+                pushRightSpine(path[depth - 1]->left);
+            } else {
+                popWhileFrom(true);
+            }
+            return *this;
+        }
+        
+        const_iterator operator--(int) {
+            const_iterator old = *this;
+            --*this;
+            return old;
+        }
+        
+        bool operator==(const const_iterator& other) const {
+            return depth == other.depth &&
+                   (depth == 0 || path[depth - 1] == other.path[depth - 1]);
+        }
+        
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+        
+    private:
+        friend class AVLTree;
+        explicit const_iterator(const AVLTree* owner) : tree(owner) {}
+        
+        void pushLeftSpine(const Node* node) {
+            for (; node; node = node->left) path[depth++] = node;
+        }
+        
+        void pushRightSpine(const Node* node) {
+            for (; node; node = node->right) path[depth++] = node;
+        }
+        
+        // Sobe enquanto o nó atual for filho direito (avanço) ou esquerdo (recuo)
+        void popWhileFrom(bool leftChild) {
+            const Node* child;
+            do {
+                child = path[--depth];
+            } while (depth > 0 &&
+                     (leftChild ? path[depth - 1]->left
+                                : path[depth - 1]->right) == child);
+        }
+        
+        const AVLTree* tree = nullptr;
+        const Node* path[MaxDepth];
+        int depth = 0;
+    };
+    
+    using iterator = const_iterator;
+    
     AVLTree() = default;
     
-    // Operações principais
-    void insert(const T& value) {
-        root = insertRec(std::move(root), value);
+    AVLTree(const AVLTree&) = delete;
+    AVLTree& operator=(const AVLTree&) = delete;
+    
+    AVLTree(AVLTree&& other) noexcept 
+        : root(other.root), allocator(std::move(other.allocator)) {
+        other.root = nullptr;
+    }
+    
+    AVLTree& operator=(AVLTree&& other) noexcept {
+        if (this != &other) {
+            destroyAll();
+            root = other.root;
+            allocator = std::move(other.allocator);
+            other.root = nullptr;
+        }
+        return *this;
+    }
+    
+    ~AVLTree() {
+        destroyAll();
+    }
+    
+    // Operações principais. Retornam false quando nada mudou (valor
+    // duplicado na inserção ou inexistente na remoção).
+    bool insert(const T& value) {
+        Node** path[MaxDepth];
+        int depth = 0;
+        Node** link = &root;
+        
+        while (*link) {
+            Node* node = *link;
+            path[depth++] = link;
+            if (lessThan(value, node->data)) {
+                link = &node->left;
+            } else if (lessThan(node->data, value)) {
+                link = &node->right;
+            } else {
+                return false; // Duplicado
+            }
+        }
+        
+        *link = allocator.create(value);
+        retrace(path, depth);
+        return true;
     }
     
-    void remove(const T& value) {
-        root = removeRec(std::move(root), value);
+    bool remove(const T& value) {
+        Node** path[MaxDepth];
+        int depth = 0;
+        Node** link = &root;
+        
+        while (*link) {
+            Node* node = *link;
+            if (lessThan(value, node->data)) {
+                path[depth++] = link;
+                link = &node->left;
+            } else if (lessThan(node->data, value)) {
+                path[depth++] = link;
+                link = &node->right;
+            } else {
+                break;
+            }
+        }
+        if (!*link) return false;
+        
+        Node* target = *link;
+        if (target->left && target->right) {
+            // Troca pelo sucessor, que tem no máximo um filho à direita
+            path[depth++] = link;
+            link = &target->right;
+            while ((*link)->left) {
+                path[depth++] = link;
+                link = &(*link)->left;
+            }
+            Node* successor = *link;
+            target->data = std::move(successor->data);
+            target = successor;
+        }
+        
+        *link = target->left ? target->left : target->right;
+        allocator.destroy(target);
+        retrace(path, depth);
+        return true;
     }
     
     bool contains(const T& value) const {
-        return searchRec(root.get(), value) != nullptr;
+        return findNode(value) != nullptr;
+    }
+    
+    // Altera no próprio nó os campos do elemento que não fazem parte da
+    // chave. mutate recebe UpdateView<T>::type (para Contact, ContactDetails),
+    // que não expõe a chave. Sem alocação nem rebalanceamento: só as
+    // contagens de marcados do caminho são recalculadas. Retorna false se
+    // a chave não existe.
+    template<typename Mutator>
+    bool update(const T& key, Mutator mutate) {
+        return updateInPlace(key, [&](T& data) {
+            typename UpdateView<T>::type view(data);
+            mutate(view);
+        });
     }
     
+    // Insere o valor ou, se a chave já existe, substitui o elemento no
+    // próprio nó. Retorna true se inseriu.
+    bool upsert(const T& value) {
+        if (updateInPlace(value, [&](T& data) { data = value; })) return false;
+        return insert(value);
+    }
+    
+    // O ponteiro permite alterar o elemento, mas não campos que afetem a
+    // ordem ou o Marker (para Contact, o favorito): isso exige remover e
+    // reinserir
     T* search(const T& value) {
-        Node* node = searchRec(root.get(), value);
+        Node* node = findNode(value);
         return node ? &node->data : nullptr;
     }
     
     const T* search(const T& value) const {
-        const Node* node = searchRec(root.get(), value);
+        const Node* node = findNode(value);
         return node ? &node->data : nullptr;
     }
     
+    // Iteração sem cópias
+    const_iterator begin() const {
+        const_iterator it(this);
+        it.pushLeftSpine(root);
+        return it;
+    }
+    
+    const_iterator end() const {
+        return const_iterator(this);
+    }
+    
+    // Primeiro elemento para o qual pred é falso. pred deve ser monótono na
+    // ordem da árvore (verdadeiro para um prefixo dos elementos), como
+    // "vem antes de x" ou "nome dobrado menor que o prefixo buscado".
+    template<typename Predicate>
+    const_iterator partitionPoint(Predicate pred) const {
+        const_iterator it(this);
+        int found = 0;
+        for (const Node* node = root; node; ) {
+            it.path[it.depth++] = node;
+            if (pred(node->data)) {
+                node = node->right;
+            } else {
+                found = it.depth;
+                node = node->left;
+            }
+        }
+        it.depth = found;
+        return it;
+    }
+    
+    // Primeiro elemento que não é menor que o valor
+    const_iterator lowerBound(const T& value) const {
+        return partitionPoint([&](const T& x) { return lessThan(x, value); });
+    }
+    
+    // Primeiro elemento maior que o valor
+    const_iterator upperBound(const T& value) const {
+        return partitionPoint([&](const T& x) { return !lessThan(value, x); });
+    }
+    
+    // Visita os elementos em [from, to), parando após limit visitas
+    // (limit < 0: sem limite). O(log n + k). Retorna quantos foram visitados.
+    template<typename Visitor>
+    int range(const T& from, const T& to, Visitor visit, int limit = -1) const {
+        int visited = 0;
+        for (auto it = lowerBound(from); it != end() && visited != limit; ++it) {
+            if (!lessThan(*it, to)) break;
+            visit(*it);
+            visited++;
+        }
+        return visited;
+    }
+    
+    // Visita cada elemento em ordem, sem alocar
+    template<typename Visitor>
+    void forEach(Visitor visit) const {
+        forEachRec(root, visit);
+    }
+    
     // Travessias
     std::vector<T> inOrder() const {
         std::vector<T> result;
-        inOrderRec(root.get(), result);
+        result.reserve(size());
+        forEach([&](const T& value) { result.push_back(value); });
         return result;
     }
     
+    // Com FavoriteMarker (padrão para Contact) custa O(f log n); com outro
+    // marcador percorre a árvore toda
     std::vector<T> getFavorites() const {
         std::vector<T> result;
-        collectFavoritesRec(root.get(), result);
+        if constexpr (std::is_base_of<FavoriteMarker, Marker>::value) {
+            result.reserve(markedCount());
+            forEachMarked([&](const T& value) { result.push_back(value); });
+        } else {
+            forEach([&](const T& value) {
+                if (value.isFavorite()) result.push_back(value);
+            });
+        }
         return result;
     }
     
     // Verificação de propriedades AVL
     bool isBalanced() const {
-        return isBalancedRec(root.get());
+        return isBalancedRec(root);
+    }
+    
+    void clear() {
+        destroyAll();
+    }
+    
+    // Operações de conjunto (join/split). Subárvores independentes são
+    // processadas em paralelo no pool; custo O(m log(n/m + 1)).
+    
+    // Acrescenta os elementos de other; em chaves repetidas fica o daqui
+    void unionWith(const AVLTree& other, ForkJoinPool& pool = ForkJoinPool::shared()) {
+        std::vector<Node*> garbage;
+        root = unionRec(root, cloneRec(other.root), pool, garbage);
+        collectGarbage(garbage);
+    }
+    
+    // Como acima, mas aproveita os nós de other, que fica vazia
+    void unionWith(AVLTree&& other, ForkJoinPool& pool = ForkJoinPool::shared()) {
+        std::vector<Node*> garbage;
+        root = unionRec(root, adoptNodes(other), pool, garbage);
+        collectGarbage(garbage);
+    }
+    
+    // Remove os elementos presentes em other
+    void difference(const AVLTree& other, ForkJoinPool& pool = ForkJoinPool::shared()) {
+        std::vector<Node*> garbage;
+        root = differenceRec(root, other.root, pool, garbage);
+        collectGarbage(garbage);
+    }
+    
+    // Mantém apenas os elementos presentes em other
+    void intersection(const AVLTree& other, ForkJoinPool& pool = ForkJoinPool::shared()) {
+        std::vector<Node*> garbage;
+        root = intersectionRec(root, other.root, pool, garbage);
+        collectGarbage(garbage);
+    }
+    
+    // Move para less os elementos menores que value e para greater os
+    // maiores. Esta árvore fica só com o elemento igual a value, se havia.
+    // Exige alocador sem estado, pois os nós mudam de árvore.
+    bool split(const T& value, AVLTree& less, AVLTree& greater) {
+        static_assert(std::is_empty<Alloc<Node>>::value,
+                      "split exige um alocador sem estado");
+        less.clear();
+        greater.clear();
+        root = split(root, value, less.root, greater.root);
+        return root != nullptr;
+    }
+    
+    // Une left < key < right em uma única árvore, em O(|altura(left) - altura(right)|).
+    // left e right ficam vazias.
+    static AVLTree join(AVLTree&& left, const T& key, AVLTree&& right) {
+        static_assert(std::is_empty<Alloc<Node>>::value,
+                      "join exige um alocador sem estado");
+        AVLTree result;
+        result.root = result.join(left.root, result.allocator.create(key), right.root);
+        left.root = right.root = nullptr;
+        return result;
+    }
+    
+    // Carga em massa
+    
+    // Substitui o conteúdo por [first, last), que deve estar ordenado e sem
+    // duplicados. Constrói a árvore de baixo para cima em O(n), sem rotações.
+    template<typename Iterator>
+    void buildFromSorted(Iterator first, Iterator last) {
+        destroyAll();
+        root = buildRec(first, std::distance(first, last));
+    }
+    
+    // Substitui o conteúdo pelos valores dados, em qualquer ordem. Duplicados
+    // são descartados (vale a primeira ocorrência). O(n log n) pela ordenação.
+    void assignBulk(std::vector<T> values) {
+        sortUnique(values);
+        buildFromSorted(std::make_move_iterator(values.begin()),
+                        std::make_move_iterator(values.end()));
+    }
+    
+    // Acrescenta vários valores de uma vez: constrói uma árvore com o lote
+    // ordenado e une com a atual. Valores já presentes não são substituídos.
+    // Retorna quantos foram inseridos.
+    int insertBulk(std::vector<T> values) {
+        AVLTree batch;
+        batch.assignBulk(std::move(values));
+        int before = size();
+        unionWith(std::move(batch));
+        return size() - before;
     }
     
     bool isEmpty() const {
@@ -227,7 +866,84 @@ public:
     }
     
     int size() const {
-        return inOrder().size();
+        return count(root);
+    }
+    
+    // Posição (a partir de 0) que o valor ocupa ou ocuparia na ordem
+    int rank(const T& value) const {
+        int position = 0;
+        const Node* node = root;
+        while (node) {
+            if (lessThan(value, node->data)) {
+                node = node->left;
+            } else {
+                int leftCount = count(node->left);
+                if (!(lessThan(node->data, value))) return position + leftCount;
+                position += leftCount + 1;
+                node = node->right;
+            }
+        }
+        return position;
+    }
+    
+    // k-ésimo menor elemento (a partir de 0), ou nullptr se fora do intervalo
+    T* select(int k) {
+        Node* node = selectNode(root, k);
+        return node ? &node->data : nullptr;
+    }
+    
+    const T* select(int k) const {
+        const Node* node = selectNode(root, k);
+        return node ? &node->data : nullptr;
+    }
+    
+    // Elementos marcados (Marker), mantidos em cada nó
+    
+    // Quantidade de elementos marcados, O(1)
+    int markedCount() const {
+        return marked(root);
+    }
+    
+    // Visita em ordem só os marcados, O(m log n) para m marcados
+    template<typename Visitor>
+    void forEachMarked(Visitor visit) const {
+        forEachMarkedRec(root, visit);
+    }
+    
+    // Quantos elementos marcados vêm antes do valor na ordem
+    int rankMarked(const T& value) const {
+        int position = 0;
+        const Node* node = root;
+        while (node) {
+            if (lessThan(value, node->data)) {
+                node = node->left;
+            } else {
+                int leftMarked = marked(node->left);
+                if (!(lessThan(node->data, value))) return position + leftMarked;
+                position += leftMarked + isMarked(node->data);
+                node = node->right;
+            }
+        }
+        return position;
+    }
+    
+    // k-ésimo elemento marcado (a partir de 0), ou nullptr se fora do intervalo
+    const T* selectMarked(int k) const {
+        const Node* node = root;
+        while (node && k >= 0 && k < node->marked) {
+            int leftMarked = marked(node->left);
+            if (k < leftMarked) {
+                node = node->left;
+                continue;
+            }
+            k -= leftMarked;
+            if (isMarked(node->data)) {
+                if (k == 0) return &node->data;
+                k--;
+            }
+            node = node->right;
+        }
+        return nullptr;
     }
 };
 
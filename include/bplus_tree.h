@@ -0,0 +1,660 @@
+#ifndef BPLUS_TREE_H
+#define BPLUS_TREE_H
+
+#include "node_marker.h"
+#include "update_view.h"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Árvore B+ com a mesma interface de AVLTree para as operações da agenda.
+// Cada nó guarda várias chaves contíguas (512 bytes de chaves, no mínimo
+// 32), então uma busca visita poucos nós e faz busca binária dentro de
+// cada um; as folhas são encadeadas, e a travessia em ordem é uma
+// varredura sequencial. T precisa ter construtor padrão.
+//
+// Diferente da AVL, os elementos mudam de posição nas escritas: ponteiros
+// e iteradores valem só até a próxima inserção ou remoção.
+template<typename T, typename Compare = std::less<T>, typename Marker = DefaultMarker<T>>
+class BPlusTree {
+public:
+    static constexpr int Capacity = sizeof(T) * 32 <= 512 ? int(512 / sizeof(T)) : 32;
+    static constexpr int MinKeys = Capacity / 2;
+
+private:
+    struct Node {
+        bool leaf;
+        int count = 0;        // Chaves em uso
+        T keys[Capacity + 1]; // Uma posição extra antes da divisão
+
+        explicit Node(bool isLeaf) : leaf(isLeaf) {}
+    };
+
+    struct Leaf : Node {
+        Leaf* prev = nullptr;
+        Leaf* next = nullptr;
+
+        Leaf() : Node(true) {}
+    };
+
+    // keys[i] é a menor chave possível em children[i + 1]
+    struct Inner : Node {
+        Node* children[Capacity + 2];
+
+        Inner() : Node(false) {}
+    };
+
+    // Nó criado pela divisão de uma subárvore e a chave que o separa
+    struct Split {
+        Node* right = nullptr;
+        T separator;
+    };
+
+    Node* root = nullptr;
+    int elementCount = 0;
+    int markedTotal = 0;
+
+    static bool lessThan(const T& a, const T& b) {
+        return Compare()(a, b);
+    }
+
+    static int isMarked(const T& value) {
+        return Marker::marked(value) ? 1 : 0;
+    }
+
+    static Leaf* asLeaf(Node* node) { return static_cast<Leaf*>(node); }
+    static const Leaf* asLeaf(const Node* node) { return static_cast<const Leaf*>(node); }
+    static Inner* asInner(Node* node) { return static_cast<Inner*>(node); }
+    static const Inner* asInner(const Node* node) { return static_cast<const Inner*>(node); }
+
+    // Primeira chave do nó que não é menor que value
+    static int lowerIndex(const Node* node, const T& value) {
+        return std::lower_bound(node->keys, node->keys + node->count, value, lessThan) - node->keys;
+    }
+
+    // Filho que pode conter value: o primeiro cujo separador é maior
+    static int childIndex(const Node* node, const T& value) {
+        return std::upper_bound(node->keys, node->keys + node->count, value, lessThan) - node->keys;
+    }
+
+    const Leaf* findLeaf(const T& value) const {
+        const Node* node = root;
+        while (node && !node->leaf) {
+            node = asInner(node)->children[childIndex(node, value)];
+        }
+        return asLeaf(node);
+    }
+
+    // Posição de value na folha, ou -1
+    static int findIn(const Leaf* leaf, const T& value) {
+        if (!leaf) return -1;
+        int i = lowerIndex(leaf, value);
+        return i < leaf->count && !lessThan(value, leaf->keys[i]) ? i : -1;
+    }
+
+    const Leaf* firstLeaf() const {
+        const Node* node = root;
+        while (node && !node->leaf) node = asInner(node)->children[0];
+        return asLeaf(node);
+    }
+
+    const Leaf* lastLeaf() const {
+        const Node* node = root;
+        while (node && !node->leaf) node = asInner(node)->children[node->count];
+        return asLeaf(node);
+    }
+
+    // Deslocamentos dentro de um nó. A posição liberada no fim recebe T()
+    // para não segurar memória de um valor já movido.
+    static void shiftKeysRight(Node* node, int from) {
+        for (int j = node->count; j > from; j--) {
+            node->keys[j] = std::move(node->keys[j - 1]);
+        }
+    }
+
+    static void shiftKeysLeft(Node* node, int from) {
+        for (int j = from; j < node->count - 1; j++) {
+            node->keys[j] = std::move(node->keys[j + 1]);
+        }
+        node->keys[node->count - 1] = T();
+    }
+
+    static void shiftChildrenRight(Inner* node, int from) {
+        for (int j = node->count + 1; j > from; j--) {
+            node->children[j] = node->children[j - 1];
+        }
+    }
+
+    static void shiftChildrenLeft(Inner* node, int from) {
+        for (int j = from; j < node->count; j++) {
+            node->children[j] = node->children[j + 1];
+        }
+    }
+
+    // Inserção recursiva. Se o nó estourar, é dividido ao meio e a metade
+    // direita volta em split para o pai.
+    bool insertRec(Node* node, const T& value, Split& split) {
+        if (node->leaf) {
+            int i = lowerIndex(node, value);
+            if (i < node->count && !lessThan(value, node->keys[i])) return false; // Duplicado
+
+            shiftKeysRight(node, i);
+            node->keys[i] = value;
+            node->count++;
+            if (node->count > Capacity) splitLeaf(asLeaf(node), split);
+            return true;
+        }
+
+        Inner* inner = asInner(node);
+        int i = childIndex(node, value);
+        Split childSplit;
+        if (!insertRec(inner->children[i], value, childSplit)) return false;
+
+        if (childSplit.right) {
+            shiftKeysRight(inner, i);
+            shiftChildrenRight(inner, i + 1);
+            inner->keys[i] = std::move(childSplit.separator);
+            inner->children[i + 1] = childSplit.right;
+            inner->count++;
+            if (inner->count > Capacity) splitInner(inner, split);
+        }
+        return true;
+    }
+
+    void splitLeaf(Leaf* leaf, Split& split) {
+        Leaf* right = new Leaf();
+        int half = leaf->count / 2;
+        for (int j = half; j < leaf->count; j++) {
+            right->keys[j - half] = std::move(leaf->keys[j]);
+            leaf->keys[j] = T();
+        }
+        right->count = leaf->count - half;
+        leaf->count = half;
+
+        right->next = leaf->next;
+        right->prev = leaf;
+        if (leaf->next) leaf->next->prev = right;
+        leaf->next = right;
+
+        split.right = right;
+        split.separator = right->keys[0];
+    }
+
+    // A chave do meio sobe para o pai
+    void splitInner(Inner* inner, Split& split) {
+        Inner* right = new Inner();
+        int mid = inner->count / 2;
+        split.separator = std::move(inner->keys[mid]);
+        inner->keys[mid] = T();
+        for (int j = mid + 1; j < inner->count; j++) {
+            right->keys[j - mid - 1] = std::move(inner->keys[j]);
+            inner->keys[j] = T();
+        }
+        for (int j = mid + 1; j <= inner->count; j++) {
+            right->children[j - mid - 1] = inner->children[j];
+        }
+        right->count = inner->count - mid - 1;
+        inner->count = mid;
+        split.right = right;
+    }
+
+    // Remoção recursiva. Filhos que ficam com menos de MinKeys chaves pegam
+    // uma emprestada de um irmão ou são fundidos com ele.
+    bool removeRec(Node* node, const T& value) {
+        if (node->leaf) {
+            int i = findIn(asLeaf(node), value);
+            if (i < 0) return false;
+
+            markedTotal -= isMarked(node->keys[i]);
+            shiftKeysLeft(node, i);
+            node->count--;
+            return true;
+        }
+
+        Inner* inner = asInner(node);
+        int i = childIndex(node, value);
+        if (!removeRec(inner->children[i], value)) return false;
+        if (inner->children[i]->count < MinKeys) rebalanceChild(inner, i);
+        return true;
+    }
+
+    void rebalanceChild(Inner* parent, int i) {
+        Node* left = i > 0 ? parent->children[i - 1] : nullptr;
+        Node* right = i < parent->count ? parent->children[i + 1] : nullptr;
+
+        if (left && left->count > MinKeys) {
+            borrowFromLeft(parent, i);
+        } else if (right && right->count > MinKeys) {
+            borrowFromRight(parent, i);
+        } else if (left) {
+            merge(parent, i - 1);
+        } else {
+            merge(parent, i);
+        }
+    }
+
+    void borrowFromLeft(Inner* parent, int i) {
+        Node* child = parent->children[i];
+        Node* left = parent->children[i - 1];
+
+        shiftKeysRight(child, 0);
+        if (child->leaf) {
+            child->keys[0] = std::move(left->keys[left->count - 1]);
+            parent->keys[i - 1] = child->keys[0];
+        } else {
+            shiftChildrenRight(asInner(child), 0);
+            child->keys[0] = std::move(parent->keys[i - 1]);
+            asInner(child)->children[0] = asInner(left)->children[left->count];
+            parent->keys[i - 1] = std::move(left->keys[left->count - 1]);
+        }
+        left->keys[left->count - 1] = T();
+        left->count--;
+        child->count++;
+    }
+
+    void borrowFromRight(Inner* parent, int i) {
+        Node* child = parent->children[i];
+        Node* right = parent->children[i + 1];
+
+        if (child->leaf) {
+            child->keys[child->count] = std::move(right->keys[0]);
+            shiftKeysLeft(right, 0);
+            right->count--;
+            parent->keys[i] = right->keys[0];
+        } else {
+            child->keys[child->count] = std::move(parent->keys[i]);
+            asInner(child)->children[child->count + 1] = asInner(right)->children[0];
+            parent->keys[i] = std::move(right->keys[0]);
+            shiftKeysLeft(right, 0);
+            shiftChildrenLeft(asInner(right), 0);
+            right->count--;
+        }
+        child->count++;
+    }
+
+    // Funde children[i + 1] em children[i]
+    void merge(Inner* parent, int i) {
+        Node* left = parent->children[i];
+        Node* right = parent->children[i + 1];
+
+        if (left->leaf) {
+            for (int j = 0; j < right->count; j++) {
+                left->keys[left->count + j] = std::move(right->keys[j]);
+            }
+            left->count += right->count;
+            Leaf* rightLeaf = asLeaf(right);
+            asLeaf(left)->next = rightLeaf->next;
+            if (rightLeaf->next) rightLeaf->next->prev = asLeaf(left);
+            delete rightLeaf;
+        } else {
+            left->keys[left->count] = std::move(parent->keys[i]);
+            for (int j = 0; j < right->count; j++) {
+                left->keys[left->count + 1 + j] = std::move(right->keys[j]);
+            }
+            for (int j = 0; j <= right->count; j++) {
+                asInner(left)->children[left->count + 1 + j] = asInner(right)->children[j];
+            }
+            left->count += right->count + 1;
+            delete asInner(right);
+        }
+
+        shiftKeysLeft(parent, i);
+        shiftChildrenLeft(parent, i + 1);
+        parent->count--;
+    }
+
+    void destroy(Node* node) {
+        if (!node) return;
+        if (node->leaf) {
+            delete asLeaf(node);
+            return;
+        }
+        Inner* inner = asInner(node);
+        for (int i = 0; i <= inner->count; i++) {
+            destroy(inner->children[i]);
+        }
+        delete inner;
+    }
+
+    // Ordem estrita dentro do nó, chaves em [lo, hi), ocupação mínima fora
+    // da raiz e todas as folhas na mesma profundidade
+    bool isValidRec(const Node* node, int depth, int& leafDepth, const T* lo, const T* hi) const {
+        if (node != root && node->count < MinKeys) return false;
+        if (node->count > Capacity || node->count == 0) return false;
+        for (int i = 0; i < node->count; i++) {
+            if (i > 0 && !lessThan(node->keys[i - 1], node->keys[i])) return false;
+            if (lo && lessThan(node->keys[i], *lo)) return false;
+            if (hi && !lessThan(node->keys[i], *hi)) return false;
+        }
+
+        if (node->leaf) {
+            if (leafDepth < 0) leafDepth = depth;
+            return leafDepth == depth;
+        }
+        const Inner* inner = asInner(node);
+        for (int i = 0; i <= inner->count; i++) {
+            const T* childLo = i > 0 ? &inner->keys[i - 1] : lo;
+            const T* childHi = i < inner->count ? &inner->keys[i] : hi;
+            if (!isValidRec(inner->children[i], depth + 1, leafDepth, childLo, childHi)) return false;
+        }
+        return true;
+    }
+
+    // Aplica change ao elemento equivalente a key, no lugar
+    template<typename Change>
+    bool updateInPlace(const T& key, Change change) {
+        Leaf* leaf = const_cast<Leaf*>(findLeaf(key));
+        int i = findIn(leaf, key);
+        if (i < 0) return false;
+
+        markedTotal -= isMarked(leaf->keys[i]);
+        change(leaf->keys[i]);
+        markedTotal += isMarked(leaf->keys[i]);
+        return true;
+    }
+
+public:
+    // Iterador bidirecional que percorre as folhas encadeadas
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+
+        reference operator*() const { return leaf->keys[index]; }
+        pointer operator->() const { return &leaf->keys[index]; }
+
+        const_iterator& operator++() {
+            if (++index == leaf->count) {
+                leaf = leaf->next;
+                index = 0;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        const_iterator& operator--() {
+            if (!leaf) {
+                leaf = tree->lastLeaf();
+                index = leaf->count - 1;
+            } else if (index == 0) {
+                leaf = leaf->prev;
+                index = leaf->count - 1;
+            } else {
+                index--;
+            }
+            return *this;
+        }
+
+        const_iterator operator--(int) {
+            const_iterator old = *this;
+            --*this;
+            return old;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return leaf == other.leaf && index == other.index;
+        }
+
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class BPlusTree;
+
+        const_iterator(const BPlusTree* owner, const Leaf* at, int i)
+            : tree(owner), leaf(at), index(i) {
+            if (leaf && index == leaf->count) {
+                leaf = leaf->next;
+                index = 0;
+            }
+        }
+
+        const BPlusTree* tree = nullptr;
+        const Leaf* leaf = nullptr;
+        int index = 0;
+    };
+
+    using iterator = const_iterator;
+
+    BPlusTree() = default;
+
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
+
+    BPlusTree(BPlusTree&& other) noexcept
+        : root(other.root), elementCount(other.elementCount), markedTotal(other.markedTotal) {
+        other.root = nullptr;
+        other.elementCount = other.markedTotal = 0;
+    }
+
+    BPlusTree& operator=(BPlusTree&& other) noexcept {
+        if (this != &other) {
+            destroy(root);
+            root = other.root;
+            elementCount = other.elementCount;
+            markedTotal = other.markedTotal;
+            other.root = nullptr;
+            other.elementCount = other.markedTotal = 0;
+        }
+        return *this;
+    }
+
+    ~BPlusTree() {
+        destroy(root);
+    }
+
+    // Operações principais. Retornam false quando nada mudou.
+    bool insert(const T& value) {
+        if (!root) {
+            Leaf* leaf = new Leaf();
+            leaf->keys[0] = value;
+            leaf->count = 1;
+            root = leaf;
+        } else {
+            Split split;
+            if (!insertRec(root, value, split)) return false;
+            if (split.right) {
+                Inner* newRoot = new Inner();
+                newRoot->keys[0] = std::move(split.separator);
+                newRoot->children[0] = root;
+                newRoot->children[1] = split.right;
+                newRoot->count = 1;
+                root = newRoot;
+            }
+        }
+        elementCount++;
+        markedTotal += isMarked(value);
+        return true;
+    }
+
+    bool remove(const T& value) {
+        if (!root || !removeRec(root, value)) return false;
+
+        elementCount--;
+        if (root->count == 0) {
+            Node* old = root;
+            root = old->leaf ? nullptr : asInner(old)->children[0];
+            if (old->leaf) {
+                delete asLeaf(old);
+            } else {
+                delete asInner(old);
+            }
+        }
+        return true;
+    }
+
+    bool contains(const T& value) const {
+        return findIn(findLeaf(value), value) >= 0;
+    }
+
+    // Vale até a próxima inserção ou remoção. Não altere campos que
+    // afetem a ordem ou o Marker; para isso use update().
+    T* search(const T& value) {
+        Leaf* leaf = const_cast<Leaf*>(findLeaf(value));
+        int i = findIn(leaf, value);
+        return i >= 0 ? &leaf->keys[i] : nullptr;
+    }
+
+    const T* search(const T& value) const {
+        const Leaf* leaf = findLeaf(value);
+        int i = findIn(leaf, value);
+        return i >= 0 ? &leaf->keys[i] : nullptr;
+    }
+
+    // Mesma semântica de AVLTree::update
+    template<typename Mutator>
+    bool update(const T& key, Mutator mutate) {
+        return updateInPlace(key, [&](T& data) {
+            typename UpdateView<T>::type view(data);
+            mutate(view);
+        });
+    }
+
+    bool upsert(const T& value) {
+        if (updateInPlace(value, [&](T& data) { data = value; })) return false;
+        return insert(value);
+    }
+
+    // Iteração
+    const_iterator begin() const {
+        return const_iterator(this, firstLeaf(), 0);
+    }
+
+    const_iterator end() const {
+        return const_iterator(this, nullptr, 0);
+    }
+
+    // Primeiro elemento que não é menor que o valor
+    const_iterator lowerBound(const T& value) const {
+        const Leaf* leaf = findLeaf(value);
+        return leaf ? const_iterator(this, leaf, lowerIndex(leaf, value)) : end();
+    }
+
+    // Primeiro elemento maior que o valor
+    const_iterator upperBound(const T& value) const {
+        const Leaf* leaf = findLeaf(value);
+        return leaf ? const_iterator(this, leaf, childIndex(leaf, value)) : end();
+    }
+
+    // Visita os elementos em [from, to), como em AVLTree::range
+    template<typename Visitor>
+    int range(const T& from, const T& to, Visitor visit, int limit = -1) const {
+        int visited = 0;
+        for (auto it = lowerBound(from); it != end() && visited != limit; ++it) {
+            if (!lessThan(*it, to)) break;
+            visit(*it);
+            visited++;
+        }
+        return visited;
+    }
+
+    template<typename Visitor>
+    void forEach(Visitor visit) const {
+        for (const Leaf* leaf = firstLeaf(); leaf; leaf = leaf->next) {
+            for (int i = 0; i < leaf->count; i++) {
+                visit(leaf->keys[i]);
+            }
+        }
+    }
+
+    // Travessias
+    std::vector<T> inOrder() const {
+        std::vector<T> result;
+        result.reserve(size());
+        forEach([&](const T& value) { result.push_back(value); });
+        return result;
+    }
+
+    std::vector<T> getFavorites() const {
+        std::vector<T> result;
+        forEach([&](const T& value) {
+            if (value.isFavorite()) result.push_back(value);
+        });
+        return result;
+    }
+
+    // Elementos marcados: a contagem total é mantida nas escritas
+    int markedCount() const {
+        return markedTotal;
+    }
+
+    template<typename Visitor>
+    void forEachMarked(Visitor visit) const {
+        forEach([&](const T& value) {
+            if (isMarked(value)) visit(value);
+        });
+    }
+
+    // Verificação das invariantes da árvore B+ (equivale a
+    // AVLTree::isBalanced): ordem, ocupação, profundidade uniforme das
+    // folhas, encadeamento e contagens
+    bool isBalanced() const {
+        if (!root) return elementCount == 0 && markedTotal == 0;
+
+        int leafDepth = -1;
+        if (!isValidRec(root, 0, leafDepth, nullptr, nullptr)) return false;
+
+        int counted = 0, marked = 0;
+        const Leaf* previous = nullptr;
+        for (const Leaf* leaf = firstLeaf(); leaf; leaf = leaf->next) {
+            if (leaf->prev != previous) return false;
+            for (int i = 0; i < leaf->count; i++) {
+                marked += isMarked(leaf->keys[i]);
+            }
+            counted += leaf->count;
+            previous = leaf;
+        }
+        return previous == lastLeaf() && counted == elementCount && marked == markedTotal;
+    }
+
+    void clear() {
+        destroy(root);
+        root = nullptr;
+        elementCount = markedTotal = 0;
+    }
+
+    // Acrescenta vários valores; os já presentes não são substituídos.
+    // Retorna quantos foram inseridos.
+    int insertBulk(std::vector<T> values) {
+        std::stable_sort(values.begin(), values.end(), lessThan);
+        int inserted = 0;
+        for (const T& value : values) {
+            inserted += insert(value);
+        }
+        return inserted;
+    }
+
+    bool isEmpty() const {
+        return root == nullptr;
+    }
+
+    int size() const {
+        return elementCount;
+    }
+
+    // Altura em níveis (1 para uma única folha)
+    int height() const {
+        int levels = 0;
+        for (const Node* node = root; node; levels++) {
+            node = node->leaf ? nullptr : asInner(node)->children[0];
+        }
+        return levels;
+    }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,119 @@
+#ifndef COLLATION_H
+#define COLLATION_H
+
+#include "contact.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// Colações: definem a ordem dos nomes na agenda. Cada uma expõe
+//   compare(a, b)        ordem total (negativo, zero ou positivo)
+//   comparePrimary(a, b) só a parte usada em buscas (ignora desempates)
+//   hasPrefix(s, p)      s começa com p segundo a colação
+// comparePrimary é monótona em relação a compare, então buscas por
+// prefixo podem usar partitionPoint/visitFrom em O(log n + k).
+
+// Ordem byte a byte, a mesma de Contact::operator<
+struct BinaryCollation {
+    static int compare(std::string_view a, std::string_view b) {
+        return a.compare(b);
+    }
+
+    static int comparePrimary(std::string_view a, std::string_view b) {
+        return a.compare(b);
+    }
+
+    static bool hasPrefix(std::string_view text, std::string_view prefix) {
+        return text.substr(0, prefix.size()) == prefix;
+    }
+};
+
+// Ignora maiúsculas/minúsculas e os acentos do Latin-1 em UTF-8 (á, Ç, õ...):
+// "ana", "Ana" e "Ána" ficam juntos e "Ágata" fica entre os nomes com A.
+// Nomes que só diferem nisso são desempatados pela ordem binária, para
+// continuarem sendo chaves distintas na árvore.
+struct FoldedCollation {
+    // Próximo caractere dobrado a partir de pos, avançando pos
+    static unsigned char nextFolded(std::string_view s, std::size_t& pos) {
+        // Letra base para U+00C0..U+00FF (segundo byte 0x80..0xBF após 0xC3)
+        static const char latin1[64] = {
+            'a', 'a', 'a', 'a', 'a', 'a', 'a', 'c', 'e', 'e', 'e', 'e', 'i', 'i', 'i', 'i',
+            'd', 'n', 'o', 'o', 'o', 'o', 'o', 0, 'o', 'u', 'u', 'u', 'u', 'y', 0, 0,
+            'a', 'a', 'a', 'a', 'a', 'a', 'a', 'c', 'e', 'e', 'e', 'e', 'i', 'i', 'i', 'i',
+            'd', 'n', 'o', 'o', 'o', 'o', 'o', 0, 'o', 'u', 'u', 'u', 'u', 'y', 0, 'y',
+        };
+
+        unsigned char c = s[pos++];
+        if (c >= 'A' && c <= 'Z') return c - 'A' + 'a';
+        if (c == 0xC3 && pos < s.size()) {
+            unsigned char next = s[pos];
+            if (next >= 0x80 && next <= 0xBF && latin1[next - 0x80]) {
+                pos++;
+                return latin1[next - 0x80];
+            }
+        }
+        return c;
+    }
+
+    // Texto inteiro dobrado; bytes nulos são descartados
+    static std::string fold(std::string_view text) {
+        std::string folded;
+        folded.reserve(text.size());
+        std::size_t pos = 0;
+        while (pos < text.size()) {
+            unsigned char c = nextFolded(text, pos);
+            if (c) folded += (char)c;
+        }
+        return folded;
+    }
+
+    static int comparePrimary(std::string_view a, std::string_view b) {
+        std::size_t i = 0, j = 0;
+        // Prefixo comum em blocos de 8 bytes: bytes iguais e todos ASCII
+        // dobram igual, então só o trecho a partir da diferença passa por
+        // nextFolded (nomes vizinhos na árvore costumam dividir o início)
+        while (i + 8 <= a.size() && i + 8 <= b.size()) {
+            std::uint64_t x, y;
+            std::memcpy(&x, a.data() + i, 8);
+            std::memcpy(&y, b.data() + i, 8);
+            if (x != y || (x & 0x8080808080808080ull)) break;
+            i += 8;
+        }
+        j = i;
+        while (i < a.size() && j < b.size()) {
+            unsigned char x = nextFolded(a, i);
+            unsigned char y = nextFolded(b, j);
+            if (x != y) return x < y ? -1 : 1;
+        }
+        if (i < a.size()) return 1;
+        if (j < b.size()) return -1;
+        return 0;
+    }
+
+    static int compare(std::string_view a, std::string_view b) {
+        int primary = comparePrimary(a, b);
+        return primary != 0 ? primary : a.compare(b);
+    }
+
+    static bool hasPrefix(std::string_view text, std::string_view prefix) {
+        std::size_t i = 0, j = 0;
+        while (j < prefix.size()) {
+            if (i >= text.size() || nextFolded(text, i) != nextFolded(prefix, j)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Ordena contatos pelo nome segundo a colação (para AVLTree/PersistentAVLTree)
+template<typename Collation>
+struct ContactOrder {
+    bool operator()(const Contact& a, const Contact& b) const {
+        return Collation::compare(a.getName(), b.getName()) < 0;
+    }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef CONCURRENT_AVL_TREE_H
+#define CONCURRENT_AVL_TREE_H
+
+#include "avl_tree.h"
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+
+// AVLTree protegida por um shared_mutex: buscas, listagens e estatísticas
+// rodam em paralelo entre si; escritas são serializadas e exclusivas.
+template<typename T, template<typename> class Alloc = HeapNodeAllocator>
+class ConcurrentAVLTree {
+public:
+    using Tree = AVLTree<T, Alloc>;
+
+private:
+    Tree tree;
+    mutable std::shared_mutex mutex;
+
+public:
+    ConcurrentAVLTree() = default;
+    ConcurrentAVLTree(const ConcurrentAVLTree&) = delete;
+    ConcurrentAVLTree& operator=(const ConcurrentAVLTree&) = delete;
+
+    // Escritas
+    bool insert(const T& value) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        return tree.insert(value);
+    }
+
+    bool remove(const T& value) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        return tree.remove(value);
+    }
+    
+    template<typename Mutator>
+    bool update(const T& key, Mutator mutate) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        return tree.update(key, mutate);
+    }
+    
+    bool upsert(const T& value) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        return tree.upsert(value);
+    }
+
+    // Leituras. find devolve uma cópia: um ponteiro para dentro da árvore
+    // ficaria inválido assim que o bloqueio fosse liberado.
+    bool contains(const T& value) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return tree.contains(value);
+    }
+
+    std::optional<T> find(const T& value) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        const T* found = tree.search(value);
+        return found ? std::optional<T>(*found) : std::nullopt;
+    }
+
+    int size() const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return tree.size();
+    }
+
+    bool isEmpty() const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return tree.isEmpty();
+    }
+
+    // Visita todos os elementos com o bloqueio compartilhado mantido
+    template<typename Visitor>
+    void forEach(Visitor visit) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        tree.forEach(visit);
+    }
+
+    // Operações compostas: f recebe a árvore e roda inteira sob um único
+    // bloqueio (compartilhado em read, exclusivo em write)
+    template<typename F>
+    auto read(F f) const -> decltype(f(std::declval<const Tree&>())) {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return f(static_cast<const Tree&>(tree));
+    }
+
+    template<typename F>
+    auto write(F f) -> decltype(f(std::declval<Tree&>())) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        return f(tree);
+    }
+};
+
+#endif
\ No newline at end of file
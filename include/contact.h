@@ -1,23 +1,36 @@
 #ifndef CONTACT_H
 #define CONTACT_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <iostream>
 
+// Nome, telefone e email ficam em um único buffer contíguo. Contatos
+// curtos (até InlineCapacity bytes somando os três campos) cabem no
+// próprio objeto, sem nenhuma alocação; os demais fazem uma só. Os getters
+// devolvem views para esse buffer, válidas até a próxima alteração.
 class Contact {
 public:
-    Contact(const std::string& name = "", const std::string& phone = "", 
-            const std::string& email = "", bool favorite = false);
+    Contact(std::string_view name = "", std::string_view phone = "", 
+            std::string_view email = "", bool favorite = false);
+    
+    Contact(const Contact& other);
+    Contact(Contact&& other) noexcept;
+    Contact& operator=(const Contact& other);
+    Contact& operator=(Contact&& other) noexcept;
+    ~Contact();
     
     // Getters
-    std::string getName() const;
-    std::string getPhone() const;
-    std::string getEmail() const;
+    std::string_view getName() const;
+    std::string_view getPhone() const;
+    std::string_view getEmail() const;
     bool isFavorite() const;
     
     // Setters
-    void setPhone(const std::string& phone);
-    void setEmail(const std::string& email);
+    void setPhone(std::string_view phone);
+    void setEmail(std::string_view email);
     void setFavorite(bool favorite);
     
     // Operadores para comparação
@@ -28,10 +41,27 @@ public:
     // Exibir contato
     void display() const;
 
+    // Bytes guardados no próprio objeto; sizeof(Contact) fica em 64
+    static constexpr std::size_t InlineCapacity = 56;
+    // Limite de cada campo (lança std::length_error acima disso)
+    static constexpr std::size_t MaxFieldLength = UINT16_MAX;
+
+    // Bytes alocados fora do objeto (0 quando os campos cabem nele)
+    std::size_t heapBytes() const;
+
 private:
-    std::string name;
-    std::string phone;
-    std::string email;
+    void assign(std::string_view name, std::string_view phone, std::string_view email);
+    void release();
+    std::size_t totalLength() const;
+    const char* data() const;
+
+    union {
+        char inlineData[InlineCapacity];
+        char* heapData;
+    };
+    std::uint16_t nameLength;
+    std::uint16_t phoneLength;
+    std::uint16_t emailLength;
     bool favorite;
 };
 
@@ -0,0 +1,359 @@
+#ifndef CONTACT_CSV_H
+#define CONTACT_CSV_H
+
+#include "contact.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CONTACT_CSV_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Busca dos bytes especiais do CSV. Com SSE2, 16 bytes são comparados de
+// uma vez e só o primeiro acerto da máscara é usado; sem SSE2, byte a byte.
+struct CsvScan {
+    // Próxima ',' ou '\n' em [from, end), ou end
+    static std::size_t separator(const char* data, std::size_t from, std::size_t end) {
+        std::size_t i = from;
+#ifdef CONTACT_CSV_SSE2
+        const __m128i comma = _mm_set1_epi8(','), newline = _mm_set1_epi8('\n');
+        for (; i + 16 <= end; i += 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            unsigned mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, comma), _mm_cmpeq_epi8(block, newline)));
+            if (mask) return i + lowestBit(mask);
+        }
+#endif
+        while (i < end && data[i] != ',' && data[i] != '\n') i++;
+        return i;
+    }
+
+    // O campo precisa de aspas: tem vírgula, aspas ou quebra de linha
+    static bool needsQuotes(std::string_view field) {
+        std::size_t i = 0;
+#ifdef CONTACT_CSV_SSE2
+        const __m128i comma = _mm_set1_epi8(','), quote = _mm_set1_epi8('"');
+        const __m128i newline = _mm_set1_epi8('\n'), carriage = _mm_set1_epi8('\r');
+        for (; i + 16 <= field.size(); i += 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(field.data() + i));
+            __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, comma), _mm_cmpeq_epi8(block, quote)),
+                                           _mm_or_si128(_mm_cmpeq_epi8(block, newline), _mm_cmpeq_epi8(block, carriage)));
+            if (_mm_movemask_epi8(special)) return true;
+        }
+#endif
+        for (; i < field.size(); i++) {
+            char c = field[i];
+            if (c == ',' || c == '"' || c == '\n' || c == '\r') return true;
+        }
+        return false;
+    }
+
+    static const char* kernelName() {
+#ifdef CONTACT_CSV_SSE2
+        return "sse2";
+#else
+        return "escalar";
+#endif
+    }
+
+private:
+    static int lowestBit(unsigned mask) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return (int)index;
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+};
+
+// Leitura de CSV (RFC 4180) em blocos de blockSize bytes: campos separados
+// por vírgula, registros por LF ou CRLF, campos entre aspas podem ter
+// vírgulas, quebras de linha e aspas dobradas (""). Um registro que não
+// cabe no resto do bloco é trazido para o início e o bloco é completado
+// (ou dobrado, se o registro sozinho o ocupa inteiro). Linhas vazias e o
+// BOM do UTF-8 são ignorados.
+class CsvReader {
+public:
+    explicit CsvReader(const std::string& path, std::size_t blockSize = 1 << 20)
+        : file(std::fopen(path.c_str(), "rb")), buffer(blockSize > 0 ? blockSize : 1, '\0') {}
+
+    CsvReader(const CsvReader&) = delete;
+    CsvReader& operator=(const CsvReader&) = delete;
+
+    ~CsvReader() {
+        if (file) std::fclose(file);
+    }
+
+    bool isOpen() const {
+        return file != nullptr;
+    }
+
+    // Próximo registro em fields; os campos apontam para o bloco e valem
+    // até a próxima chamada. false no fim do arquivo ou em erro (ok()
+    // falso): aspas sem fechar, texto depois das aspas ou falha de leitura.
+    bool next(std::vector<std::string_view>& fields) {
+        fields.clear();
+        while (file && !failed) {
+            if (begin == end || !started) {
+                if (!refill()) return false;
+                continue;
+            }
+            std::size_t after;
+            Parse result = parseRecord(after);
+            if (result == Parse::NeedMore) {
+                refill();
+                continue;
+            }
+            if (result == Parse::Invalid) {
+                failed = true;
+                return false;
+            }
+            begin = after;
+            if (spans.size() == 1 && spans[0].length == 0) continue;
+
+            count++;
+            for (Span& span : spans) {
+                if (span.escaped) unescape(span);
+                fields.emplace_back(buffer.data() + span.start, span.length);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    bool ok() const {
+        return file && !failed;
+    }
+
+    // Registros já entregues; num erro, o seguinte é o inválido
+    std::size_t records() const {
+        return count;
+    }
+
+private:
+    enum class Parse { Done, NeedMore, Invalid };
+
+    struct Span {
+        std::size_t start, length;
+        bool escaped; // tem aspas dobradas
+    };
+
+    // Registro a partir de begin; after recebe o início do seguinte.
+    // Nada é alterado no bloco até o registro estar completo.
+    Parse parseRecord(std::size_t& after) {
+        spans.clear();
+        const char* data = buffer.data();
+        std::size_t i = begin;
+        while (true) {
+            if (i < end && data[i] == '"') {
+                std::size_t start = ++i;
+                bool escaped = false;
+                while (true) {
+                    const void* quote = std::memchr(data + i, '"', end - i);
+                    if (!quote) return eof ? Parse::Invalid : Parse::NeedMore;
+                    i = (const char*)quote - data;
+                    if (i + 1 == end && !eof) return Parse::NeedMore;
+                    if (i + 1 < end && data[i + 1] == '"') {
+                        escaped = true;
+                        i += 2;
+                        continue;
+                    }
+                    break;
+                }
+                spans.push_back({start, i - start, escaped});
+                i++;
+                if (!eof && (i == end || (data[i] == '\r' && i + 1 == end))) return Parse::NeedMore;
+                if (i < end && data[i] == '\r' && i + 1 < end && data[i + 1] == '\n') i++;
+                if (i == end || data[i] == '\n') {
+                    after = i < end ? i + 1 : end;
+                    return Parse::Done;
+                }
+                if (data[i] != ',') return Parse::Invalid;
+                i++;
+                continue;
+            }
+
+            std::size_t stop = CsvScan::separator(data, i, end);
+            if (stop == end && !eof) return Parse::NeedMore;
+            std::size_t fieldEnd = stop;
+            bool lastField = stop == end || data[stop] == '\n';
+            if (lastField && fieldEnd > i && data[fieldEnd - 1] == '\r') fieldEnd--;
+            spans.push_back({i, fieldEnd - i, false});
+            if (lastField) {
+                after = stop < end ? stop + 1 : end;
+                return Parse::Done;
+            }
+            i = stop + 1;
+        }
+    }
+
+    // "" -> " dentro do próprio bloco (o campo só encolhe)
+    void unescape(Span& span) {
+        char* field = &buffer[span.start];
+        std::size_t written = 0;
+        for (std::size_t i = 0; i < span.length; i++) {
+            field[written++] = field[i];
+            if (field[i] == '"') i++;
+        }
+        span.length = written;
+    }
+
+    // Move o registro incompleto para o início e completa o bloco
+    bool refill() {
+        if (eof) {
+            failed = failed || begin != end;
+            return false;
+        }
+        std::size_t pending = end - begin;
+        if (begin == 0 && pending == buffer.size()) buffer.resize(buffer.size() * 2);
+        std::memmove(&buffer[0], buffer.data() + begin, pending);
+        begin = 0;
+        end = pending;
+
+        std::size_t wanted = buffer.size() - end;
+        std::size_t read = std::fread(&buffer[end], 1, wanted, file);
+        end += read;
+        if (read < wanted) {
+            eof = true;
+            failed = std::ferror(file) != 0;
+        }
+        if (!started && (end >= 3 || eof)) {
+            started = true;
+            if (end >= 3 && std::memcmp(buffer.data(), "\xEF\xBB\xBF", 3) == 0) begin = 3;
+        }
+        return true;
+    }
+
+    std::FILE* file;
+    std::string buffer;
+    std::size_t begin = 0, end = 0;
+    std::vector<Span> spans;
+    std::size_t count = 0;
+    bool eof = false, failed = false, started = false;
+};
+
+// Escrita de CSV (RFC 4180) por um buffer de blockSize bytes: campos com
+// vírgula, aspas ou quebra de linha vão entre aspas, com as aspas
+// dobradas; registros terminam em CRLF.
+class CsvWriter {
+public:
+    explicit CsvWriter(const std::string& path, std::size_t blockSize = 1 << 20)
+        : file(std::fopen(path.c_str(), "wb")), blockSize(blockSize) {
+        buffer.reserve(blockSize + 256);
+    }
+
+    CsvWriter(const CsvWriter&) = delete;
+    CsvWriter& operator=(const CsvWriter&) = delete;
+
+    ~CsvWriter() {
+        close();
+    }
+
+    bool isOpen() const {
+        return file != nullptr;
+    }
+
+    void field(std::string_view value) {
+        if (!firstField) buffer += ',';
+        firstField = false;
+        if (!CsvScan::needsQuotes(value)) {
+            buffer.append(value);
+            return;
+        }
+        buffer += '"';
+        for (std::size_t quote; (quote = value.find('"')) != std::string_view::npos; value.remove_prefix(quote + 1)) {
+            buffer.append(value.substr(0, quote + 1));
+            buffer += '"';
+        }
+        buffer.append(value);
+        buffer += '"';
+    }
+
+    void endRecord() {
+        buffer += "\r\n";
+        firstField = true;
+        if (buffer.size() >= blockSize) flush();
+    }
+
+    // Grava o resto e fecha; false se alguma escrita falhou
+    bool close() {
+        if (!file) return false;
+        flush();
+        ok = std::fclose(file) == 0 && ok;
+        file = nullptr;
+        return ok;
+    }
+
+private:
+    void flush() {
+        ok = ok && std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+        buffer.clear();
+    }
+
+    std::FILE* file;
+    std::size_t blockSize;
+    std::string buffer;
+    bool firstField = true;
+    bool ok = true;
+};
+
+// Agenda em CSV: cabeçalho "Nome,Telefone,Email,Favorito" e um registro
+// por contato passado por forEach(visit)
+template<typename ForEach>
+bool writeContactsCsv(const std::string& path, ForEach forEach) {
+    CsvWriter csv(path);
+    if (!csv.isOpen()) return false;
+    for (const char* column : {"Nome", "Telefone", "Email", "Favorito"}) csv.field(column);
+    csv.endRecord();
+    forEach([&](const Contact& contact) {
+        csv.field(contact.getName());
+        csv.field(contact.getPhone());
+        csv.field(contact.getEmail());
+        csv.field(contact.isFavorite() ? "true" : "false");
+        csv.endRecord();
+    });
+    return csv.close();
+}
+
+// Resultado de readContactsCsv
+struct CsvImport {
+    std::vector<Contact> contacts;
+    std::size_t skipped = 0; // registros sem nome ou com campo longo demais
+    bool opened = false;
+    bool ok = false;         // falso: registro invalidRecord mal formado
+    std::size_t invalidRecord = 0;
+};
+
+// Contatos de um CSV como o de writeContactsCsv. O cabeçalho é reconhecido
+// pelo primeiro campo "Nome"; campos que faltam ficam vazios.
+inline CsvImport readContactsCsv(const std::string& path) {
+    CsvImport result;
+    CsvReader csv(path);
+    result.opened = csv.isOpen();
+    std::vector<std::string_view> fields;
+    while (csv.next(fields)) {
+        if (csv.records() == 1 && fields[0] == "Nome") continue;
+        fields.resize(4, "");
+        if (fields[0].empty() || fields[0].size() > Contact::MaxFieldLength ||
+            fields[1].size() > Contact::MaxFieldLength || fields[2].size() > Contact::MaxFieldLength) {
+            result.skipped++;
+            continue;
+        }
+        result.contacts.emplace_back(fields[0], fields[1], fields[2], fields[3] == "true");
+    }
+    result.ok = csv.ok();
+    if (!result.ok) result.invalidRecord = csv.records() + 1;
+    return result;
+}
+
+#endif
\ No newline at end of file
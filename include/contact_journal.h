@@ -0,0 +1,505 @@
+#ifndef CONTACT_JOURNAL_H
+#define CONTACT_JOURNAL_H
+
+#include "contact.h"
+#include "contact_snapshot.h"
+#include "gzip.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+// Persistência da agenda: log de escrita antecipada (WAL) e snapshots
+// (contact_snapshot.h) em um diretório. Cada alteração vira um registro no
+// fim de agenda.wal, com tamanho e CRC32: o contato inteiro (put) ou só o
+// nome (remove). Como os registros trazem o estado final, reaplicá-los é
+// idempotente: na partida o último snapshot é carregado e o log é
+// reaplicado por cima, até o primeiro registro incompleto (gravação
+// interrompida por uma queda).
+//
+// Os registros são anotados em memória (logPut/logRemove, na ordem das
+// escritas) e commit() os torna duráveis conforme o modo:
+//   PerOperation: quem chama commit grava e faz fsync antes de retornar.
+//   PerBatch: commit espera a thread do log, que grava tudo o que foi
+//     anotado até ali com um só fsync (group commit); escritores
+//     simultâneos dividem o mesmo fsync.
+//   Async: commit retorna na hora e a thread grava a cada flushInterval;
+//     uma queda perde no máximo esse intervalo.
+// Quando o log passa de checkpointSize, uma segunda thread grava um
+// snapshot (checkpoint) com a versão atual e descarta o log que ele cobre;
+// a do log continua atendendo os commits enquanto isso.
+class ContactJournal {
+public:
+    enum class Durability { PerOperation, PerBatch, Async };
+
+    // Escreve uma versão consistente da agenda no snapshot
+    using Source = std::function<void(ContactSnapshot::Writer&)>;
+
+    explicit ContactJournal(std::string directory, Durability durability = Durability::PerBatch,
+                            std::chrono::milliseconds flushInterval = std::chrono::milliseconds(100))
+        : directory(std::move(directory)), durability(durability), flushInterval(flushInterval) {}
+
+    ContactJournal(const ContactJournal&) = delete;
+    ContactJournal& operator=(const ContactJournal&) = delete;
+
+    ~ContactJournal() {
+        close();
+    }
+
+    // Lê o snapshot e os logs: load(snapshot) recebe o snapshot mapeado
+    // (para montar a agenda de uma vez) e depois put(contato) e
+    // remove(nome) recebem os registros do log na ordem original. Falso se
+    // o snapshot está corrompido; nesse caso nada deve ser gravado por cima.
+    template<typename Load, typename Put, typename Remove>
+    bool recover(Load load, Put put, Remove remove) {
+        fresh = true;
+        validLogBytes = 0;
+        std::error_code error;
+        if (std::filesystem::exists(snapshotPath(), error)) {
+            fresh = false;
+            ContactSnapshot snapshot;
+            if (!snapshot.open(snapshotPath())) return false;
+            load(snapshot);
+        }
+
+        std::string data;
+        Record record;
+        for (const std::string& path : {oldLogPath(), logPath()}) {
+            if (!readFile(path, data)) continue;
+            fresh = false;
+            std::size_t pos = 0;
+            while (readRecord(data, pos, record)) {
+                if (record.type == 'P') {
+                    put(Contact(record.name, record.phone, record.email, record.favorite));
+                } else {
+                    remove(record.name);
+                }
+            }
+            // O resto (registro incompleto) é descartado ao abrir o log
+            if (path == logPath()) validLogBytes = pos;
+            logBytes += pos;
+        }
+        return true;
+    }
+
+    // Mesmo que o anterior, com os contatos do snapshot passados um a um a put
+    template<typename Put, typename Remove>
+    bool recover(Put put, Remove remove) {
+        auto load = [&](const ContactSnapshot& snapshot) {
+            for (std::size_t i = 0; i < snapshot.size(); i++) put(snapshot[i].toContact());
+        };
+        return recover(load, put, remove);
+    }
+
+    // Abre agenda.wal para anotar (depois de recover) e inicia a thread
+    bool open() {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error) return false;
+
+        fd = openFile(logPath(), false);
+        if (fd < 0) return false;
+        if (std::filesystem::file_size(logPath(), error) > validLogBytes &&
+            !(truncateFile(fd, validLogBytes) && syncFile(fd))) {
+            return false;
+        }
+        running = true;
+        worker = std::thread([this] { run(); });
+        checkpointer = std::thread([this] { runCheckpoints(); });
+        return true;
+    }
+
+    // Grava o que falta e para a thread
+    void close() {
+        if (running) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            checkpointWake.notify_all();
+            worker.join();
+            checkpointer.join();
+            running = false;
+        }
+        flush();
+        if (fd >= 0) closeFile(fd);
+        fd = -1;
+    }
+
+    // Nenhum snapshot nem log existia (agenda nova)
+    bool isNew() const {
+        return fresh;
+    }
+
+    // Bytes de log desde o último snapshot
+    std::uint64_t logSize() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return logBytes;
+    }
+
+    // Checkpoints automáticos: quando o log passa de bytes, uma thread
+    // própria lê a agenda por source, enquanto a do log segue gravando os
+    // commits que chegam (os dois só dividem o arquivo na troca do log)
+    void setCheckpointSource(Source checkpointSource, std::uint64_t bytes = 64 << 20) {
+        std::lock_guard<std::mutex> lock(mutex);
+        source = std::move(checkpointSource);
+        checkpointSize = bytes;
+    }
+
+    void logPut(const Contact& contact) {
+        std::lock_guard<std::mutex> lock(mutex);
+        appendPut(pending, contact);
+        appended++;
+    }
+
+    void logRemove(std::string_view name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::size_t start = beginRecord(pending, 'R');
+        appendLittleEndian(pending, (std::uint16_t)name.size());
+        pending.append(name);
+        endRecord(pending, start);
+        appended++;
+    }
+
+    // Torna duráveis os registros anotados até aqui, conforme o modo.
+    // Falso se a gravação falhou (o log para de aceitar commits).
+    bool commit() {
+        std::unique_lock<std::mutex> lock(mutex);
+        std::uint64_t target = appended;
+        if (failed || durability == Durability::Async || durable >= target) return !failed;
+        if (durability == Durability::PerOperation || !running) {
+            lock.unlock();
+            return flush();
+        }
+        requested = std::max(requested, target);
+        wake.notify_one();
+        flushed.wait(lock, [&] { return durable >= target || failed; });
+        return !failed;
+    }
+
+    // Uma gravação já falhou: nada anotado daqui em diante fica durável
+    bool hasFailed() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return failed;
+    }
+
+    // Grava um snapshot com os contatos de source e descarta o log que ele
+    // cobre. O log é trocado antes (agenda.wal vira agenda.wal.old), então
+    // a versão lida por source já contém tudo o que está em agenda.wal.old;
+    // o snapshot é escrito ao lado e renomeado por cima do anterior.
+    // source deve passar os contatos na ordem da agenda.
+    bool checkpoint(const Source& source) {
+        std::lock_guard<std::mutex> guard(checkpointMutex);
+        if (!rotate()) return false;
+
+        std::string tempPath = snapshotPath() + ".tmp";
+        int out = openFile(tempPath, true);
+        ContactSnapshot::Writer writer([&](std::string_view data) { return out >= 0 && writeAll(out, data); });
+        source(writer);
+        bool ok = writer.finish() && writeAt(out, 0, writer.header()) && syncFile(out);
+        if (out >= 0) closeFile(out);
+
+        std::error_code error;
+        if (ok) std::filesystem::rename(tempPath, snapshotPath(), error);
+        if (!ok || error || !syncDirectory(directory)) {
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+        std::filesystem::remove(oldLogPath(), error);
+        return true;
+    }
+
+private:
+    // Registro decodificado; as views apontam para o arquivo lido
+    struct Record {
+        char type; // 'P' (put) ou 'R' (remove)
+        bool favorite;
+        std::string_view name, phone, email;
+    };
+
+    std::string snapshotPath() const {
+        return directory + "/agenda.snapshot";
+    }
+
+    std::string logPath() const {
+        return directory + "/agenda.wal";
+    }
+
+    std::string oldLogPath() const {
+        return directory + "/agenda.wal.old";
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            auto interval = durability == Durability::Async ? flushInterval : std::chrono::milliseconds(1000);
+            wake.wait_for(lock, interval, [&] { return stopping || requested > durable; });
+            lock.unlock();
+            flush();
+            lock.lock();
+            if (source && logBytes >= checkpointSize && !checkpointDue) {
+                checkpointDue = true;
+                checkpointWake.notify_one();
+            }
+        }
+    }
+
+    void runCheckpoints() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            checkpointWake.wait(lock, [&] { return stopping || checkpointDue; });
+            if (stopping) return;
+            Source checkpointSource = source;
+            lock.unlock();
+            checkpoint(checkpointSource);
+            lock.lock();
+            checkpointDue = false;
+        }
+    }
+
+    bool flush() {
+        std::lock_guard<std::mutex> file(fileMutex);
+        return flushLocked();
+    }
+
+    // Grava e sincroniza tudo o que foi anotado; fileMutex já está com quem chama
+    bool flushLocked() {
+        std::string batch;
+        std::uint64_t upTo;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            batch.swap(pending);
+            upTo = appended;
+        }
+        bool ok = batch.empty() || (fd >= 0 && writeAll(fd, batch) && syncFile(fd));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (ok) {
+                durable = std::max(durable, upTo);
+                logBytes += batch.size();
+            } else {
+                failed = true;
+            }
+        }
+        flushed.notify_all();
+        return ok;
+    }
+
+    // agenda.wal -> agenda.wal.old e um agenda.wal novo. Se um checkpoint
+    // anterior falhou, agenda.wal.old ainda existe e fica como está: o
+    // próximo snapshot cobre os dois.
+    bool rotate() {
+        std::lock_guard<std::mutex> file(fileMutex);
+        if (!flushLocked()) return false;
+        std::error_code error;
+        if (std::filesystem::exists(oldLogPath(), error)) return true;
+
+        closeFile(fd);
+        std::filesystem::rename(logPath(), oldLogPath(), error);
+        fd = openFile(logPath(), false);
+        if (error || fd < 0 || !syncDirectory(directory)) return false;
+        std::lock_guard<std::mutex> lock(mutex);
+        logBytes = 0;
+        return true;
+    }
+
+    // Registro: tamanho e CRC32 do conteúdo (4 bytes cada), depois o tipo
+    static std::size_t beginRecord(std::string& out, char type) {
+        std::size_t start = out.size();
+        out.append(8, '\0');
+        out += type;
+        return start;
+    }
+
+    static void endRecord(std::string& out, std::size_t start) {
+        std::string_view payload(out.data() + start + 8, out.size() - start - 8);
+        std::uint32_t length = (std::uint32_t)payload.size(), crc = Gzip::crc32(payload);
+        for (int i = 0; i < 4; i++) {
+            out[start + i] = (char)(length >> (8 * i));
+            out[start + 4 + i] = (char)(crc >> (8 * i));
+        }
+    }
+
+    static void appendPut(std::string& out, const Contact& contact) {
+        std::size_t start = beginRecord(out, 'P');
+        out += (char)contact.isFavorite();
+        appendLittleEndian(out, (std::uint16_t)contact.getName().size());
+        appendLittleEndian(out, (std::uint16_t)contact.getPhone().size());
+        appendLittleEndian(out, (std::uint16_t)contact.getEmail().size());
+        out.append(contact.getName());
+        out.append(contact.getPhone());
+        out.append(contact.getEmail());
+        endRecord(out, start);
+    }
+
+    template<typename Int>
+    static void appendLittleEndian(std::string& out, Int value) {
+        for (std::size_t i = 0; i < sizeof(Int); i++) out += (char)(value >> (8 * i));
+    }
+
+    template<typename Int>
+    static Int readLittleEndian(std::string_view data, std::size_t pos) {
+        Int value = 0;
+        for (std::size_t i = 0; i < sizeof(Int); i++) value |= (Int)(unsigned char)data[pos + i] << (8 * i);
+        return value;
+    }
+
+    // Registro em pos; falso (pos inalterado) se incompleto ou corrompido
+    static bool readRecord(std::string_view data, std::size_t& pos, Record& record) {
+        if (data.size() - pos < 9) return false;
+        std::uint32_t length = readLittleEndian<std::uint32_t>(data, pos);
+        if (length == 0 || length > data.size() - pos - 8) return false;
+        std::string_view payload = data.substr(pos + 8, length);
+        if (Gzip::crc32(payload) != readLittleEndian<std::uint32_t>(data, pos + 4)) return false;
+
+        record.type = payload[0];
+        if (record.type == 'P' && payload.size() >= 8) {
+            std::size_t nameLength = readLittleEndian<std::uint16_t>(payload, 2);
+            std::size_t phoneLength = readLittleEndian<std::uint16_t>(payload, 4);
+            std::size_t emailLength = readLittleEndian<std::uint16_t>(payload, 6);
+            if (payload.size() != 8 + nameLength + phoneLength + emailLength) return false;
+            record.favorite = payload[1] != 0;
+            record.name = payload.substr(8, nameLength);
+            record.phone = payload.substr(8 + nameLength, phoneLength);
+            record.email = payload.substr(8 + nameLength + phoneLength);
+        } else if (record.type == 'R' && payload.size() >= 3) {
+            std::size_t nameLength = readLittleEndian<std::uint16_t>(payload, 1);
+            if (payload.size() != 3 + nameLength) return false;
+            record.name = payload.substr(3);
+        } else {
+            return false;
+        }
+        pos += 8 + length;
+        return true;
+    }
+
+    static bool readFile(const std::string& path, std::string& out) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return false;
+        out.resize((std::size_t)file.tellg());
+        file.seekg(0);
+        return (bool)file.read(&out[0], out.size());
+    }
+
+    // Descritores de arquivo, para fsync (_commit no Windows)
+    static int openFile(const std::string& path, bool truncate) {
+#ifdef _WIN32
+        return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_BINARY | (truncate ? _O_TRUNC : _O_APPEND),
+                     _S_IREAD | _S_IWRITE);
+#else
+        return ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : O_APPEND), 0644);
+#endif
+    }
+
+    static bool writeAll(int file, std::string_view data) {
+        while (!data.empty()) {
+#ifdef _WIN32
+            int written = _write(file, data.data(), (unsigned)std::min<std::size_t>(data.size(), 1 << 30));
+#else
+            ssize_t written = ::write(file, data.data(), data.size());
+            if (written < 0 && errno == EINTR) continue;
+#endif
+            if (written <= 0) return false;
+            data.remove_prefix(written);
+        }
+        return true;
+    }
+
+    static bool syncFile(int file) {
+#ifdef _WIN32
+        return _commit(file) == 0;
+#else
+        return ::fsync(file) == 0;
+#endif
+    }
+
+    static bool truncateFile(int file, std::uint64_t size) {
+#ifdef _WIN32
+        return _chsize_s(file, (long long)size) == 0;
+#else
+        return ::ftruncate(file, (off_t)size) == 0;
+#endif
+    }
+
+    // Escrita numa posição do arquivo (o cabeçalho do snapshot, no fim)
+    static bool writeAt(int file, std::uint64_t offset, std::string_view data) {
+#ifdef _WIN32
+        return _lseeki64(file, (long long)offset, SEEK_SET) >= 0 && writeAll(file, data);
+#else
+        while (!data.empty()) {
+            ssize_t written = ::pwrite(file, data.data(), data.size(), (off_t)offset);
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) return false;
+            data.remove_prefix(written);
+            offset += written;
+        }
+        return true;
+#endif
+    }
+
+    static void closeFile(int file) {
+#ifdef _WIN32
+        _close(file);
+#else
+        ::close(file);
+#endif
+    }
+
+    // Renomeações só são duráveis com fsync do diretório (POSIX)
+    static bool syncDirectory(const std::string& path) {
+#ifdef _WIN32
+        (void)path;
+        return true;
+#else
+        int dir = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (dir < 0) return false;
+        bool ok = ::fsync(dir) == 0;
+        ::close(dir);
+        return ok;
+#endif
+    }
+
+    std::string directory;
+    Durability durability;
+    std::chrono::milliseconds flushInterval;
+    bool fresh = true;
+    std::uint64_t validLogBytes = 0;
+
+    // Anotações e contadores (mutex); arquivo do log (fileMutex)
+    mutable std::mutex mutex;
+    std::string pending;
+    std::uint64_t appended = 0;  // Registros anotados
+    std::uint64_t durable = 0;   // Registros gravados com fsync
+    std::uint64_t requested = 0; // Maior commit esperando a thread
+    std::uint64_t logBytes = 0;
+    bool failed = false;
+    bool stopping = false;
+    Source source;
+    std::uint64_t checkpointSize = 64 << 20;
+    bool checkpointDue = false;  // Pedido à thread de checkpoint
+    std::condition_variable wake, flushed, checkpointWake;
+
+    std::mutex fileMutex;
+    std::mutex checkpointMutex;
+    int fd = -1;
+    std::thread worker, checkpointer;
+    bool running = false;
+};
+
+#endif
\ No newline at end of file
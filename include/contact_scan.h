@@ -0,0 +1,234 @@
+#ifndef CONTACT_SCAN_H
+#define CONTACT_SCAN_H
+
+#include "collation.h"
+#include "contact.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CONTACT_SCAN_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define CONTACT_SCAN_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Busca de substring em um buffer. Os núcleos vetoriais comparam o
+// primeiro e o último byte do padrão com 16 (SSE2) ou 32 (AVX2) posições
+// de uma vez e só conferem o resto com memcmp nas candidatas. find() usa
+// o melhor disponível na compilação (-mavx2 habilita o AVX2); os outros
+// ficam expostos para o benchmark.
+struct SubstringScan {
+    static constexpr std::size_t npos = std::string_view::npos;
+
+    static std::size_t scalar(std::string_view text, std::string_view pattern, std::size_t from) {
+        std::size_t m = pattern.size();
+        if (m == 0) return from <= text.size() ? from : npos;
+        for (std::size_t i = from; i + m <= text.size(); i++) {
+            if (text[i] == pattern[0] && text[i + m - 1] == pattern[m - 1] &&
+                std::memcmp(text.data() + i, pattern.data(), m) == 0) {
+                return i;
+            }
+        }
+        return npos;
+    }
+
+#ifdef CONTACT_SCAN_SSE2
+    static std::size_t sse2(std::string_view text, std::string_view pattern, std::size_t from) {
+        std::size_t m = pattern.size();
+        if (m == 0) return scalar(text, pattern, from);
+
+        const __m128i first = _mm_set1_epi8(pattern[0]);
+        const __m128i last = _mm_set1_epi8(pattern[m - 1]);
+        std::size_t i = from;
+        for (; i + m - 1 + 16 <= text.size(); i += 16) {
+            __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i));
+            __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i + m - 1));
+            unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first),
+                                                            _mm_cmpeq_epi8(blockLast, last)));
+            if (std::size_t found = verify(text, pattern, i, mask); found != npos) return found;
+        }
+        return scalar(text, pattern, i);
+    }
+#endif
+
+#ifdef CONTACT_SCAN_AVX2
+    static std::size_t avx2(std::string_view text, std::string_view pattern, std::size_t from) {
+        std::size_t m = pattern.size();
+        if (m == 0) return scalar(text, pattern, from);
+
+        const __m256i first = _mm256_set1_epi8(pattern[0]);
+        const __m256i last = _mm256_set1_epi8(pattern[m - 1]);
+        std::size_t i = from;
+        for (; i + m - 1 + 32 <= text.size(); i += 32) {
+            __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + i));
+            __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + i + m - 1));
+            unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first),
+                                                                            _mm256_cmpeq_epi8(blockLast, last)));
+            if (std::size_t found = verify(text, pattern, i, mask); found != npos) return found;
+        }
+        return scalar(text, pattern, i);
+    }
+#endif
+
+    static std::size_t find(std::string_view text, std::string_view pattern, std::size_t from = 0) {
+#if defined(CONTACT_SCAN_AVX2)
+        return avx2(text, pattern, from);
+#elif defined(CONTACT_SCAN_SSE2)
+        return sse2(text, pattern, from);
+#else
+        return scalar(text, pattern, from);
+#endif
+    }
+
+    static const char* kernelName() {
+#if defined(CONTACT_SCAN_AVX2)
+        return "avx2";
+#elif defined(CONTACT_SCAN_SSE2)
+        return "sse2";
+#else
+        return "escalar";
+#endif
+    }
+
+private:
+    static int lowestBit(unsigned mask) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return (int)index;
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    // Confere as posições candidatas (bits de mask a partir de base)
+    static std::size_t verify(std::string_view text, std::string_view pattern,
+                              std::size_t base, unsigned mask) {
+        while (mask) {
+            std::size_t i = base + lowestBit(mask);
+            if (std::memcmp(text.data() + i + 1, pattern.data() + 1, pattern.size() - 1) == 0 ||
+                pattern.size() == 1) {
+                return i;
+            }
+            mask &= mask - 1;
+        }
+        return npos;
+    }
+};
+
+// Cópia colunar de uma versão da agenda para busca por trecho em nome,
+// telefone ou email. Cada coluna é um buffer contínuo com os valores já
+// dobrados (sem maiúsculas e acentos, como FoldedCollation), separados por
+// '\0', e a busca é uma varredura sequencial com SubstringScan. Imutável
+// depois de construída; reconstruir custa O(total de bytes).
+class ContactScanIndex {
+public:
+    // source: qualquer coleção com forEach em ordem (AVLTree, snapshots)
+    template<typename Source>
+    explicit ContactScanIndex(const Source& source) {
+        source.forEach([&](const Contact& contact) {
+            names.append(contact.getName());
+            phones.append(contact.getPhone());
+            emails.append(contact.getEmail());
+            contacts.push_back(contact);
+        });
+        names.finish();
+        phones.finish();
+        emails.finish();
+    }
+
+    int size() const {
+        return (int)contacts.size();
+    }
+
+    // Visita, na ordem da agenda, os contatos com o trecho no nome, telefone
+    // ou email, até limit (limit < 0: todos). Retorna quantos foram visitados.
+    template<typename Visitor>
+    int search(std::string_view query, Visitor visit, int limit = -1) const {
+        std::string pattern = fold(query);
+        if (pattern.empty() || limit == 0) return 0;
+
+        // Os primeiros limit da união estão entre os primeiros limit de cada coluna
+        std::vector<std::uint32_t> byName = names.matches(pattern, limit);
+        std::vector<std::uint32_t> byPhone = phones.matches(pattern, limit);
+        std::vector<std::uint32_t> byEmail = emails.matches(pattern, limit);
+
+        std::vector<std::uint32_t> merged;
+        merged.reserve(byName.size() + byPhone.size() + byEmail.size());
+        merged.insert(merged.end(), byName.begin(), byName.end());
+        merged.insert(merged.end(), byPhone.begin(), byPhone.end());
+        merged.insert(merged.end(), byEmail.begin(), byEmail.end());
+        std::sort(merged.begin(), merged.end());
+        merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+
+        int visited = 0;
+        for (std::uint32_t id : merged) {
+            if (visited == limit) break;
+            visit(contacts[id]);
+            visited++;
+        }
+        return visited;
+    }
+
+    // Texto dobrado como nas colunas
+    static std::string fold(std::string_view text) {
+        return FoldedCollation::fold(text);
+    }
+
+private:
+    struct Column {
+        std::string text;                 // Valores dobrados separados por '\0'
+        std::vector<std::uint32_t> starts; // Início de cada valor, mais o fim
+
+        void append(std::string_view value) {
+            starts.push_back((std::uint32_t)text.size());
+            std::size_t pos = 0;
+            while (pos < value.size()) {
+                unsigned char c = FoldedCollation::nextFolded(value, pos);
+                if (c) text += (char)c;
+            }
+            text += '\0';
+        }
+
+        void finish() {
+            starts.push_back((std::uint32_t)text.size());
+            text.shrink_to_fit();
+        }
+
+        // Registros com o padrão, em ordem, no máximo limit (< 0: todos)
+        std::vector<std::uint32_t> matches(const std::string& pattern, int limit) const {
+            std::vector<std::uint32_t> found;
+            std::size_t from = 0;
+            while (limit < 0 || (int)found.size() < limit) {
+                std::size_t pos = SubstringScan::find(text, pattern, from);
+                if (pos == SubstringScan::npos) break;
+
+                std::uint32_t id = std::upper_bound(starts.begin(), starts.end(), (std::uint32_t)pos) -
+                                   starts.begin() - 1;
+                found.push_back(id);
+                from = starts[id + 1]; // Um resultado por registro
+            }
+            return found;
+        }
+    };
+
+    std::vector<Contact> contacts;
+    Column names;
+    Column phones;
+    Column emails;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,368 @@
+#ifndef CONTACT_SNAPSHOT_H
+#define CONTACT_SNAPSHOT_H
+
+#include "contact.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Hash de 64 bits no estilo do xxHash (quatro acumuladores sobre blocos de
+// 32 bytes), calculado aos pedaços. Rápido o bastante para validar na
+// partida snapshots de centenas de MB.
+class SnapshotChecksum {
+public:
+    void update(std::string_view data) {
+        total += data.size();
+        if (tailSize > 0) {
+            std::size_t take = std::min(data.size(), sizeof(tail) - tailSize);
+            std::memcpy(tail + tailSize, data.data(), take);
+            tailSize += take;
+            data.remove_prefix(take);
+            if (tailSize < sizeof(tail)) return;
+            block(tail);
+            tailSize = 0;
+        }
+        while (data.size() >= sizeof(tail)) {
+            block(data.data());
+            data.remove_prefix(sizeof(tail));
+        }
+        std::memcpy(tail, data.data(), data.size());
+        tailSize = data.size();
+    }
+
+    std::uint64_t value() const {
+        std::uint64_t hash = rotate(lanes[0], 1) + rotate(lanes[1], 7) + rotate(lanes[2], 12) + rotate(lanes[3], 18);
+        hash += total;
+        for (std::size_t i = 0; i < tailSize; i++) {
+            hash ^= (unsigned char)tail[i] * Prime5;
+            hash = rotate(hash, 11) * Prime1;
+        }
+        hash ^= hash >> 33;
+        hash *= Prime2;
+        hash ^= hash >> 29;
+        hash *= Prime3;
+        return hash ^ (hash >> 32);
+    }
+
+private:
+    static constexpr std::uint64_t Prime1 = 0x9E3779B185EBCA87ull, Prime2 = 0xC2B2AE3D27D4EB4Full;
+    static constexpr std::uint64_t Prime3 = 0x165667B19E3779F9ull, Prime5 = 0x27D4EB2F165667C5ull;
+
+    static std::uint64_t rotate(std::uint64_t x, int bits) {
+        return (x << bits) | (x >> (64 - bits));
+    }
+
+    void block(const char* data) {
+        for (int i = 0; i < 4; i++) {
+            std::uint64_t word;
+            std::memcpy(&word, data + 8 * i, 8);
+            lanes[i] = rotate(lanes[i] + word * Prime2, 31) * Prime1;
+        }
+    }
+
+    std::uint64_t lanes[4] = {Prime1 + Prime2, Prime2, 0, 0 - Prime1};
+    std::uint64_t total = 0;
+    char tail[32];
+    std::size_t tailSize = 0;
+};
+
+// Snapshot binário da agenda (versão 2):
+//   cabeçalho, 64 bytes: "AGENDASN", versão, tamanho do registro,
+//     quantidade de contatos, tamanho dos textos, posição dos registros,
+//     tamanho das duas ordens de índice e o checksum do resto do arquivo
+//   textos: nome, telefone e email de cada contato, em sequência
+//   registros, 16 bytes por contato, na ordem da agenda: posição dos
+//     textos, os três tamanhos e o favorito
+//   ordens dos índices por telefone e por email (opcionais): o número do
+//     registro de cada entrada, na ordem do índice
+// O arquivo é mapeado na memória (mmap) e os contatos são lidos direto da
+// imagem: o i-ésimo registro está numa posição fixa, sem decodificar nada
+// antes dele. Com as ordens gravadas, os índices também são remontados sem
+// ordenar. Inteiros em little-endian.
+class ContactSnapshot {
+public:
+    static constexpr std::uint32_t Version = 2;
+    static constexpr std::size_t HeaderSize = 64;
+    static constexpr std::size_t RecordSize = 16;
+
+    // Contato visto dentro da imagem mapeada
+    struct Entry {
+        std::string_view name, phone, email;
+        bool favorite;
+
+        Contact toContact() const {
+            return Contact(name, phone, email, favorite);
+        }
+    };
+
+    // Monta o arquivo aos pedaços, entregues a sink: add() para cada
+    // contato na ordem da agenda, as ordens de índice (se houver),
+    // finish() e então header() escrito no início, no lugar do provisório
+    class Writer {
+    public:
+        using Sink = std::function<bool(std::string_view)>;
+
+        explicit Writer(Sink sink) : sink(std::move(sink)), buffer(HeaderSize, '\0') {}
+
+        void add(const Contact& contact) {
+            char record[RecordSize] = {};
+            putLittleEndian(record, heapSize);
+            putLittleEndian(record + 8, (std::uint16_t)contact.getName().size());
+            putLittleEndian(record + 10, (std::uint16_t)contact.getPhone().size());
+            putLittleEndian(record + 12, (std::uint16_t)contact.getEmail().size());
+            record[14] = contact.isFavorite();
+            records.append(record, RecordSize);
+
+            std::size_t before = buffer.size();
+            buffer.append(contact.getName());
+            buffer.append(contact.getPhone());
+            buffer.append(contact.getEmail());
+            heapSize += buffer.size() - before;
+            count++;
+            if (buffer.size() >= (1 << 20)) flush();
+        }
+
+        // Próxima entrada do índice por telefone / email: o número do
+        // registro (posição do contato na ordem da agenda)
+        void addPhoneOrder(std::uint32_t record) {
+            putLittleEndian(phoneOrder, record);
+        }
+
+        void addEmailOrder(std::uint32_t record) {
+            putLittleEndian(emailOrder, record);
+        }
+
+        // Alinhamento, registros e ordens; falso se sink falhou
+        bool finish() {
+            buffer.append((8 - heapSize % 8) % 8, '\0');
+            flush();
+            for (std::string* section : {&records, &phoneOrder, &emailOrder}) {
+                checksum.update(*section);
+                ok = ok && sink(*section);
+            }
+            return ok;
+        }
+
+        std::string header() const {
+            std::string header(HeaderSize, '\0');
+            std::memcpy(&header[0], "AGENDASN", 8);
+            putLittleEndian(&header[8], Version);
+            putLittleEndian(&header[12], (std::uint32_t)RecordSize);
+            putLittleEndian(&header[16], count);
+            putLittleEndian(&header[24], heapSize);
+            putLittleEndian(&header[32], (std::uint64_t)(HeaderSize + (heapSize + 7) / 8 * 8));
+            putLittleEndian(&header[40], (std::uint64_t)phoneOrder.size() / 4);
+            putLittleEndian(&header[48], (std::uint64_t)emailOrder.size() / 4);
+            putLittleEndian(&header[56], checksum.value());
+            return header;
+        }
+
+    private:
+        // O cabeçalho provisório sai junto com os primeiros textos
+        void flush() {
+            checksum.update(std::string_view(buffer).substr(headerPending ? HeaderSize : 0));
+            headerPending = false;
+            ok = ok && sink(buffer);
+            buffer.clear();
+        }
+
+        Sink sink;
+        std::string buffer;
+        std::string records, phoneOrder, emailOrder;
+        std::uint64_t heapSize = 0;
+        std::uint64_t count = 0;
+        SnapshotChecksum checksum;
+        bool headerPending = true;
+        bool ok = true;
+    };
+
+    ContactSnapshot() = default;
+    ContactSnapshot(const ContactSnapshot&) = delete;
+    ContactSnapshot& operator=(const ContactSnapshot&) = delete;
+
+    ~ContactSnapshot() {
+        unmap();
+    }
+
+    // Começa com a assinatura de um snapshot deste formato
+    static bool hasSignature(std::string_view prefix) {
+        return prefix.substr(0, 8) == "AGENDASN";
+    }
+
+    // Mapeia o arquivo e valida cabeçalho, checksum e os limites de cada
+    // registro; falso se não existe ou é inválido
+    bool open(const std::string& path) {
+        unmap();
+        if (!map(path) || length < HeaderSize || !hasSignature(std::string_view(data, 8))) return false;
+
+        std::string_view image(data, length);
+        std::uint64_t records = readLittleEndian<std::uint64_t>(image, 16);
+        std::uint64_t heapSize = readLittleEndian<std::uint64_t>(image, 24);
+        std::uint64_t phones = readLittleEndian<std::uint64_t>(image, 40);
+        std::uint64_t emails = readLittleEndian<std::uint64_t>(image, 48);
+        recordsOffset = readLittleEndian<std::uint64_t>(image, 32);
+        // Cada tamanho é limitado pelo arquivo antes de entrar numa conta,
+        // para nenhuma delas estourar
+        if (readLittleEndian<std::uint32_t>(image, 8) != Version ||
+            readLittleEndian<std::uint32_t>(image, 12) != RecordSize || heapSize > length - HeaderSize ||
+            recordsOffset != HeaderSize + (heapSize + 7) / 8 * 8 || recordsOffset > length ||
+            records > (length - recordsOffset) / RecordSize || records > (std::uint64_t)INT_MAX ||
+            phones > records || emails > records ||
+            length - recordsOffset - records * RecordSize != (phones + emails) * 4) {
+            return fail();
+        }
+
+        SnapshotChecksum checksum;
+        checksum.update(image.substr(HeaderSize));
+        if (checksum.value() != readLittleEndian<std::uint64_t>(image, 56)) return fail();
+        count = records;
+        phoneCount = phones;
+        emailCount = emails;
+
+        heap = image.substr(HeaderSize, heapSize);
+        for (std::size_t i = 0; i < count; i++) {
+            std::string_view record = image.substr(recordsOffset + i * RecordSize, RecordSize);
+            std::uint64_t offset = readLittleEndian<std::uint64_t>(record, 0);
+            std::uint64_t size = (std::uint64_t)readLittleEndian<std::uint16_t>(record, 8) +
+                                 readLittleEndian<std::uint16_t>(record, 10) + readLittleEndian<std::uint16_t>(record, 12);
+            if (offset > heap.size() || size > heap.size() - offset) return fail();
+        }
+        for (std::size_t i = 0; i < phoneCount + emailCount; i++) {
+            if (readLittleEndian<std::uint32_t>(image, orderOffset() + 4 * i) >= count) return fail();
+        }
+        return true;
+    }
+
+    std::size_t size() const {
+        return count;
+    }
+
+    // i-ésimo contato, sem cópia; vale enquanto o arquivo estiver mapeado
+    Entry operator[](std::size_t i) const {
+        std::string_view record(data + recordsOffset + i * RecordSize, RecordSize);
+        std::size_t offset = readLittleEndian<std::uint64_t>(record, 0);
+        std::size_t nameLength = readLittleEndian<std::uint16_t>(record, 8);
+        std::size_t phoneLength = readLittleEndian<std::uint16_t>(record, 10);
+        std::size_t emailLength = readLittleEndian<std::uint16_t>(record, 12);
+        return {heap.substr(offset, nameLength), heap.substr(offset + nameLength, phoneLength),
+                heap.substr(offset + nameLength + phoneLength, emailLength), record[14] != 0};
+    }
+
+    // Ordens gravadas dos índices por telefone e email: número do registro
+    // da i-ésima entrada (0 entradas se o snapshot não as tem)
+    std::size_t phoneOrderSize() const {
+        return phoneCount;
+    }
+
+    std::uint32_t phoneOrder(std::size_t i) const {
+        return readLittleEndian<std::uint32_t>(std::string_view(data, length), orderOffset() + 4 * i);
+    }
+
+    std::size_t emailOrderSize() const {
+        return emailCount;
+    }
+
+    std::uint32_t emailOrder(std::size_t i) const {
+        return readLittleEndian<std::uint32_t>(std::string_view(data, length), orderOffset() + 4 * (phoneCount + i));
+    }
+
+    std::vector<Contact> contacts() const {
+        std::vector<Contact> all;
+        all.reserve(count);
+        for (std::size_t i = 0; i < count; i++) all.push_back((*this)[i].toContact());
+        return all;
+    }
+
+private:
+    template<typename Int>
+    static void putLittleEndian(char* out, Int value) {
+        for (std::size_t i = 0; i < sizeof(Int); i++) out[i] = (char)(value >> (8 * i));
+    }
+
+    template<typename Int>
+    static void putLittleEndian(std::string& out, Int value) {
+        for (std::size_t i = 0; i < sizeof(Int); i++) out += (char)(value >> (8 * i));
+    }
+
+    template<typename Int>
+    static Int readLittleEndian(std::string_view data, std::size_t pos) {
+        Int value = 0;
+        for (std::size_t i = 0; i < sizeof(Int); i++) value |= (Int)(unsigned char)data[pos + i] << (8 * i);
+        return value;
+    }
+
+    std::size_t orderOffset() const {
+        return recordsOffset + count * RecordSize;
+    }
+
+    bool fail() {
+        unmap();
+        return false;
+    }
+
+    // mmap somente leitura; no Windows o arquivo é lido para a memória
+    bool map(const std::string& path) {
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return false;
+        buffer.resize((std::size_t)file.tellg());
+        file.seekg(0);
+        if (!file.read(&buffer[0], buffer.size())) return false;
+        data = buffer.data();
+        length = buffer.size();
+        return true;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat info;
+        bool ok = ::fstat(fd, &info) == 0 && info.st_size > 0;
+        if (ok) {
+            void* address = ::mmap(nullptr, (std::size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ok = address != MAP_FAILED;
+            if (ok) {
+                data = (const char*)address;
+                length = (std::size_t)info.st_size;
+                ::madvise(address, length, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(fd);
+        return ok;
+#endif
+    }
+
+    void unmap() {
+#ifdef _WIN32
+        buffer.clear();
+#else
+        if (data) ::munmap((void*)data, length);
+#endif
+        data = nullptr;
+        length = 0;
+        count = phoneCount = emailCount = 0;
+    }
+
+    const char* data = nullptr;
+    std::size_t length = 0;
+    std::size_t count = 0;
+    std::size_t phoneCount = 0, emailCount = 0;
+    std::uint64_t recordsOffset = 0;
+    std::string_view heap;
+#ifdef _WIN32
+    std::string buffer;
+#endif
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,417 @@
+#ifndef CONTACT_STORE_H
+#define CONTACT_STORE_H
+
+#include "contact.h"
+#include "contact_snapshot.h"
+#include "persistent_avl_tree.h"
+#include "update_view.h"
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Telefone normalizado: só os dígitos ("(11) 9999-8888" -> "1199998888")
+inline std::string normalizePhone(std::string_view phone) {
+    std::string digits;
+    for (char c : phone) {
+        if (std::isdigit((unsigned char)c)) digits += c;
+    }
+    return digits;
+}
+
+// Email normalizado: sem espaços nas pontas e em minúsculas
+inline std::string normalizeEmail(std::string_view email) {
+    size_t start = email.find_first_not_of(" \t");
+    size_t end = email.find_last_not_of(" \t");
+    if (start == std::string_view::npos) return "";
+
+    std::string normalized(email.substr(start, end - start + 1));
+    for (char& c : normalized) {
+        c = std::tolower((unsigned char)c);
+    }
+    return normalized;
+}
+
+// Agenda com vários índices: a árvore principal por nome e índices
+// secundários ordenados por telefone e email normalizados. Os três são
+// árvores persistentes publicadas juntas como uma única versão, então
+// leitores sempre veem índices consistentes com a árvore principal, sem
+// bloqueio. Telefone e email podem se repetir entre contatos.
+template<typename NameOrder = std::less<Contact>>
+class ContactStore {
+private:
+    // Entrada de índice secundário: chave normalizada -> nome do contato
+    struct IndexEntry {
+        std::string key;
+        std::string name;
+    };
+
+    struct IndexOrder {
+        bool operator()(const IndexEntry& a, const IndexEntry& b) const {
+            int byKey = a.key.compare(b.key);
+            return byKey != 0 ? byKey < 0 : a.name < b.name;
+        }
+    };
+
+public:
+    using NameIndex = typename PersistentAVLTree<Contact, NameOrder, FavoriteMarker>::Snapshot;
+    using KeyIndex = typename PersistentAVLTree<IndexEntry, IndexOrder, NoMarker>::Snapshot;
+
+    // Versão imutável da agenda com todos os índices
+    class Snapshot {
+    public:
+        int size() const {
+            return names.size();
+        }
+
+        bool isEmpty() const {
+            return names.isEmpty();
+        }
+
+        const Contact* search(const Contact& key) const {
+            return names.search(key);
+        }
+
+        bool contains(const Contact& key) const {
+            return names.contains(key);
+        }
+
+        // Favoritos, contados em cada nó da árvore por nome
+        int favoriteCount() const {
+            return names.markedCount();
+        }
+
+        template<typename Visitor>
+        void forEachFavorite(Visitor visit) const {
+            names.forEachMarked(visit);
+        }
+
+        // Contatos com o telefone dado, O(log n + k)
+        std::vector<Contact> findByPhone(std::string_view phone) const {
+            return findBy(phones, normalizePhone(phone));
+        }
+
+        // Contatos com o email dado, O(log n + k)
+        std::vector<Contact> findByEmail(std::string_view email) const {
+            return findBy(emails, normalizeEmail(email));
+        }
+
+        // Índice principal, para listagens e consultas por intervalo
+        const NameIndex& byName() const {
+            return names;
+        }
+
+        template<typename Visitor>
+        void forEach(Visitor visit) const {
+            names.forEach(visit);
+        }
+
+        // Grava esta versão num snapshot em disco, junto com a ordem dos
+        // índices por telefone e email (posição de cada nome pela contagem
+        // dos nós), para assign() não precisar ordená-los de novo
+        void writeTo(ContactSnapshot::Writer& writer) const {
+            names.forEach([&](const Contact& contact) { writer.add(contact); });
+            phones.forEach([&](const IndexEntry& entry) { writer.addPhoneOrder(names.rank(Contact(entry.name))); });
+            emails.forEach([&](const IndexEntry& entry) { writer.addEmailOrder(names.rank(Contact(entry.name))); });
+        }
+
+        // Árvores balanceadas e índices sem entradas além dos contatos
+        bool isBalanced() const {
+            return names.isBalanced() && phones.isBalanced() && emails.isBalanced() &&
+                   phones.size() <= names.size() && emails.size() <= names.size();
+        }
+
+        // Mesma versão publicada (índices derivados podem ser reaproveitados)
+        bool sameVersion(const Snapshot& other) const {
+            return names.sameVersion(other.names) && phones.sameVersion(other.phones) &&
+                   emails.sameVersion(other.emails);
+        }
+
+    private:
+        friend class ContactStore;
+
+        std::vector<Contact> findBy(const KeyIndex& index, const std::string& key) const {
+            std::vector<Contact> found;
+            if (key.empty()) return found;
+
+            index.visitFrom(
+                [&](const IndexEntry& entry) { return entry.key < key; },
+                [&](const IndexEntry& entry) {
+                    if (entry.key != key) return false;
+                    const Contact* contact = names.search(Contact(entry.name));
+                    if (contact) found.push_back(*contact);
+                    return true;
+                });
+            return found;
+        }
+
+        NameIndex names;
+        KeyIndex phones;
+        KeyIndex emails;
+    };
+
+    // Alterações sobre uma cópia local da versão atual, publicadas de uma vez
+    // ao final de modify(). Cada operação mantém os três índices em acordo.
+    class Transaction {
+    public:
+        const Contact* search(const Contact& key) const {
+            return version.names.search(key);
+        }
+
+        bool insert(const Contact& contact) {
+            NameIndex names = version.names.inserted(contact);
+            if (names.sameVersion(version.names)) return false; // Duplicado
+
+            version.names = names;
+            addKeys(contact);
+            record(std::nullopt, contact);
+            return true;
+        }
+
+        bool remove(const Contact& key) {
+            const Contact* current = version.names.search(key);
+            if (!current) return false;
+
+            Contact removed = *current;
+            version.names = version.names.removed(removed);
+            removeKeys(removed);
+            record(removed, std::nullopt);
+            return true;
+        }
+
+        // Substitui o contato de mesmo nome, reindexando telefone e email
+        // só se mudaram. A árvore por nome não é rebalanceada.
+        bool replace(const Contact& contact) {
+            const Contact* current = version.names.search(contact);
+            if (!current) return false;
+
+            Contact previous = *current;
+            version.names = version.names.replaced(contact);
+            if (normalizePhone(previous.getPhone()) != normalizePhone(contact.getPhone()) ||
+                normalizeEmail(previous.getEmail()) != normalizeEmail(contact.getEmail())) {
+                removeKeys(previous);
+                addKeys(contact);
+            }
+            record(previous, contact);
+            return true;
+        }
+
+        // Altera os campos que não são a chave; mutate recebe ContactDetails
+        template<typename Mutator>
+        bool update(const Contact& key, Mutator mutate) {
+            const Contact* current = version.names.search(key);
+            if (!current) return false;
+
+            Contact updated = *current;
+            ContactDetails details(updated);
+            mutate(details);
+            return replace(updated);
+        }
+
+        // Insere ou substitui; retorna true se inseriu
+        bool upsert(const Contact& contact) {
+            if (replace(contact)) return false;
+            return insert(contact);
+        }
+
+    private:
+        friend class ContactStore;
+
+        struct Change {
+            std::optional<Contact> before;
+            std::optional<Contact> after;
+        };
+
+        Transaction(Snapshot base, bool recording) : version(std::move(base)), recording(recording) {}
+
+        void record(std::optional<Contact> before, std::optional<Contact> after) {
+            if (recording) changes.push_back({std::move(before), std::move(after)});
+        }
+
+        void addKeys(const Contact& contact) {
+            std::string phone = normalizePhone(contact.getPhone());
+            std::string email = normalizeEmail(contact.getEmail());
+            if (!phone.empty()) {
+                version.phones = version.phones.inserted({phone, std::string(contact.getName())});
+            }
+            if (!email.empty()) {
+                version.emails = version.emails.inserted({email, std::string(contact.getName())});
+            }
+        }
+
+        void removeKeys(const Contact& contact) {
+            version.phones = version.phones.removed({normalizePhone(contact.getPhone()), std::string(contact.getName())});
+            version.emails = version.emails.removed({normalizeEmail(contact.getEmail()), std::string(contact.getName())});
+        }
+
+        Snapshot version;
+        bool recording;
+        std::vector<Change> changes;
+    };
+
+    // Recebe cada contato inserido (before nulo), removido (after nulo) ou
+    // substituído, na ordem das operações, depois que a versão é publicada
+    using ChangeListener = std::function<void(const Contact* before, const Contact* after)>;
+
+    ContactStore() : current(std::make_shared<const Snapshot>()) {}
+    ContactStore(const ContactStore&) = delete;
+    ContactStore& operator=(const ContactStore&) = delete;
+
+    // Leitura sem bloqueio da versão atual
+    Snapshot snapshot() const {
+        return *std::atomic_load(&current);
+    }
+
+    // Operação composta: f recebe uma Transaction e retorna se algo mudou.
+    // Escritores são serializados; leitores nunca esperam.
+    template<typename F>
+    bool modify(F f) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        Transaction transaction(snapshot(), (bool)listener);
+        bool changed = f(transaction);
+        if (changed) {
+            std::atomic_store(&current, std::make_shared<const Snapshot>(transaction.version));
+            for (const auto& change : transaction.changes) {
+                listener(change.before ? &*change.before : nullptr, change.after ? &*change.after : nullptr);
+            }
+        }
+        return changed;
+    }
+
+    // Índices mantidos fora da agenda (ex.: FuzzyIndex) acompanham as
+    // escritas por aqui; o listener roda com os escritores bloqueados
+    void setChangeListener(ChangeListener changeListener) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        listener = std::move(changeListener);
+    }
+
+    // Substitui a agenda pelos n contatos dados por next(), como os de um
+    // snapshot em disco, sem avisar o listener. Em ordem de nome e sem
+    // repetidos, a árvore por nome é montada em O(n), sem rotações, e os
+    // índices por telefone e email a partir das entradas ordenadas uma vez.
+    // Fora dessa ordem (ex.: outra collation) retorna false sem mudar nada.
+    template<typename Next>
+    bool assignSorted(int n, Next next) {
+        std::vector<IndexEntry> phoneEntries, emailEntries;
+        phoneEntries.reserve(n);
+        emailEntries.reserve(n);
+        Contact previous;
+        bool sorted = true;
+        int read = 0;
+        NameIndex names = NameIndex::fromSorted(n, [&] {
+            Contact contact = next();
+            if (read++ > 0 && !NameOrder()(previous, contact)) sorted = false;
+            std::string phone = normalizePhone(contact.getPhone());
+            std::string email = normalizeEmail(contact.getEmail());
+            if (!phone.empty()) phoneEntries.push_back({std::move(phone), std::string(contact.getName())});
+            if (!email.empty()) emailEntries.push_back({std::move(email), std::string(contact.getName())});
+            previous = contact;
+            return contact;
+        });
+        if (!sorted) return false;
+
+        Snapshot version;
+        version.names = names;
+        version.phones = sortedIndex(phoneEntries);
+        version.emails = sortedIndex(emailEntries);
+        std::lock_guard<std::mutex> lock(writeMutex);
+        std::atomic_store(&current, std::make_shared<const Snapshot>(std::move(version)));
+        return true;
+    }
+
+    // Substitui a agenda por um snapshot gravado com writeTo(), sem avisar
+    // o listener. As três árvores são montadas em O(n): por nome na ordem
+    // dos registros e os índices na ordem gravada. Um índice sem ordem
+    // gravada, ou com uma que não confere, é ordenado como em assignSorted.
+    // Contatos fora da ordem de nome: false sem mudar nada.
+    bool assign(const ContactSnapshot& snapshot) {
+        int n = (int)snapshot.size(), phoneCount = 0, emailCount = 0, read = 0;
+        std::string_view previous;
+        bool sorted = true;
+        NameIndex names = NameIndex::fromSorted(n, [&] {
+            ContactSnapshot::Entry entry = snapshot[read];
+            if (read++ > 0 && !NameOrder()(Contact(previous), Contact(entry.name))) sorted = false;
+            if (entry.phone.find_first_of("0123456789") != std::string_view::npos) phoneCount++;
+            if (entry.email.find_first_not_of(" \t") != std::string_view::npos) emailCount++;
+            previous = entry.name;
+            return entry.toContact();
+        });
+        if (!sorted) return false;
+
+        auto phoneOf = [](const ContactSnapshot::Entry& entry) { return normalizePhone(entry.phone); };
+        auto emailOf = [](const ContactSnapshot::Entry& entry) { return normalizeEmail(entry.email); };
+        Snapshot version;
+        version.names = names;
+        version.phones = storedIndex(snapshot, (int)snapshot.phoneOrderSize(), phoneCount,
+                                     [&](int i) { return snapshot.phoneOrder(i); }, phoneOf);
+        version.emails = storedIndex(snapshot, (int)snapshot.emailOrderSize(), emailCount,
+                                     [&](int i) { return snapshot.emailOrder(i); }, emailOf);
+        std::lock_guard<std::mutex> lock(writeMutex);
+        std::atomic_store(&current, std::make_shared<const Snapshot>(std::move(version)));
+        return true;
+    }
+
+    bool insert(const Contact& contact) {
+        return modify([&](Transaction& tx) { return tx.insert(contact); });
+    }
+
+    bool remove(const Contact& key) {
+        return modify([&](Transaction& tx) { return tx.remove(key); });
+    }
+
+    bool replace(const Contact& contact) {
+        return modify([&](Transaction& tx) { return tx.replace(contact); });
+    }
+
+    template<typename Mutator>
+    bool update(const Contact& key, Mutator mutate) {
+        return modify([&](Transaction& tx) { return tx.update(key, mutate); });
+    }
+
+private:
+    static KeyIndex sortedIndex(std::vector<IndexEntry>& entries) {
+        std::sort(entries.begin(), entries.end(), IndexOrder());
+        std::size_t next = 0;
+        return KeyIndex::fromSorted((int)entries.size(), [&] { return std::move(entries[next++]); });
+    }
+
+    // Índice na ordem gravada no snapshot (record(i): registro da i-ésima
+    // entrada). A ordem só vale se tem uma entrada por contato com chave
+    // e cresce estritamente; senão as entradas são refeitas e ordenadas.
+    template<typename Record, typename KeyOf>
+    static KeyIndex storedIndex(const ContactSnapshot& snapshot, int size, int expected, Record record, KeyOf keyOf) {
+        if (size == expected) {
+            IndexEntry previous;
+            bool ordered = true;
+            int read = 0;
+            KeyIndex index = KeyIndex::fromSorted(size, [&] {
+                ContactSnapshot::Entry contact = snapshot[record(read)];
+                IndexEntry entry{keyOf(contact), std::string(contact.name)};
+                if (entry.key.empty() || (read++ > 0 && !IndexOrder()(previous, entry))) ordered = false;
+                previous = entry;
+                return entry;
+            });
+            if (ordered) return index;
+        }
+
+        std::vector<IndexEntry> entries;
+        entries.reserve(expected);
+        for (std::size_t i = 0; i < snapshot.size(); i++) {
+            ContactSnapshot::Entry contact = snapshot[i];
+            std::string key = keyOf(contact);
+            if (!key.empty()) entries.push_back({std::move(key), std::string(contact.name)});
+        }
+        return sortedIndex(entries);
+    }
+
+    std::shared_ptr<const Snapshot> current; // Publicado com atomic_store
+    std::mutex writeMutex;
+    ChangeListener listener;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,110 @@
+#ifndef FORK_JOIN_POOL_H
+#define FORK_JOIN_POOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool de threads para paralelismo fork-join. invoke(a, b) executa a na
+// thread atual e publica b para os workers; se ninguém pegou b até a
+// terminar, a própria thread o executa. Assim chamadas aninhadas nunca
+// ficam esperando por uma tarefa que não está em andamento.
+class ForkJoinPool {
+private:
+    struct Task {
+        std::function<void()> run;
+        bool done = false;
+    };
+
+    std::vector<std::thread> workers;
+    std::deque<Task*> queue;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable taskDone;
+    bool stopping = false;
+
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            taskAvailable.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping) return;
+
+            Task* task = queue.front();
+            queue.pop_front();
+            lock.unlock();
+            task->run();
+            lock.lock();
+            task->done = true;
+            taskDone.notify_all();
+        }
+    }
+
+public:
+    // workerCount = 0 executa tudo na thread chamadora
+    explicit ForkJoinPool(unsigned workerCount) {
+        for (unsigned i = 0; i < workerCount; i++) {
+            workers.emplace_back(&ForkJoinPool::workerLoop, this);
+        }
+    }
+
+    ForkJoinPool(const ForkJoinPool&) = delete;
+    ForkJoinPool& operator=(const ForkJoinPool&) = delete;
+
+    ~ForkJoinPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        taskAvailable.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    // Pool compartilhado com uma thread a menos que os núcleos disponíveis
+    // (a thread chamadora também trabalha)
+    static ForkJoinPool& shared() {
+        static ForkJoinPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+        return pool;
+    }
+
+    unsigned workerCount() const {
+        return workers.size();
+    }
+
+    template<typename A, typename B>
+    void invoke(A&& a, B&& b) {
+        if (workers.empty()) {
+            a();
+            b();
+            return;
+        }
+
+        Task task;
+        task.run = std::forward<B>(b);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(&task);
+        }
+        taskAvailable.notify_one();
+
+        a();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        auto pending = std::find(queue.begin(), queue.end(), &task);
+        if (pending != queue.end()) {
+            // Ninguém pegou a tarefa: executa aqui mesmo
+            queue.erase(pending);
+            lock.unlock();
+            task.run();
+            return;
+        }
+        taskDone.wait(lock, [&task] { return task.done; });
+    }
+};
+
+#endif
\ No newline at end of file
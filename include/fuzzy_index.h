@@ -0,0 +1,246 @@
+#ifndef FUZZY_INDEX_H
+#define FUZZY_INDEX_H
+
+#include "collation.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Busca tolerante a erros de digitação ("Beatris Santo" -> "Beatriz Santos").
+// Índice invertido de trigramas dos nomes e emails dobrados (sem maiúsculas e
+// acentos): cada trigrama aponta para a lista ordenada dos contatos que o
+// contêm. Uma consulta só calcula distância para os contatos que dividem
+// trigramas suficientes com ela; a distância é Damerau (Levenshtein com
+// transposições) entre a consulta e o melhor trecho do nome ou do email,
+// com corte assim que passa do limite.
+//
+// O índice é atualizado a cada escrita (set/remove). Entradas removidas
+// ficam marcadas nas listas e são descartadas de uma vez quando passam da
+// metade, então o custo de remoção é O(1) amortizado.
+class FuzzyIndex {
+public:
+    static constexpr int MaxQueryLength = 64;
+
+    // Insere o contato ou atualiza o email do contato de mesmo nome
+    void set(std::string_view name, std::string_view email) {
+        std::string foldedEmail = FoldedCollation::fold(email);
+        auto existing = idByName.find(std::string(name));
+        if (existing != idByName.end()) {
+            if (entries[existing->second].email == foldedEmail) return;
+            discard(existing->second);
+        }
+
+        std::uint32_t id = (std::uint32_t)entries.size();
+        entries.push_back({std::string(name), FoldedCollation::fold(name), std::move(foldedEmail), true});
+        idByName[std::string(name)] = id;
+        addGrams(id);
+        live++;
+        // Trocar o email descarta a entrada antiga
+        compactIfSparse();
+    }
+
+    bool remove(std::string_view name) {
+        auto existing = idByName.find(std::string(name));
+        if (existing == idByName.end()) return false;
+
+        discard(existing->second);
+        idByName.erase(existing);
+        compactIfSparse();
+        return true;
+    }
+
+    int size() const {
+        return live;
+    }
+
+    // Visita até limit nomes, do mais próximo ao mais distante, como
+    // visit(nome, distância). maxDistance < 0 escolhe pelo tamanho da
+    // consulta (0 até 3 caracteres, 1 até 6, 2 acima). Consultas com menos
+    // de 3 caracteres não têm trigramas e não encontram nada.
+    template<typename Visitor>
+    int search(std::string_view query, int limit, Visitor visit, int maxDistance = -1) const {
+        std::string pattern = FoldedCollation::fold(query);
+        if (pattern.size() > (std::size_t)MaxQueryLength) pattern.resize(MaxQueryLength);
+        if (pattern.size() < 3 || limit <= 0) return 0;
+        int k = maxDistance >= 0 ? maxDistance : pattern.size() <= 3 ? 0 : pattern.size() <= 6 ? 1 : 2;
+
+        // Cada edição destrói no máximo 4 trigramas da consulta (uma
+        // transposição mexe em duas posições), então um contato a distância
+        // <= d divide pelo menos Q - 4d deles, e aparece em alguma das
+        // 4d + 1 listas mais curtas. Os trigramas em comum são contados de
+        // uma vez; depois os candidatos são conferidos com d = 0, 1, ..., k,
+        // parando no primeiro nível em que já há limit resultados.
+        std::vector<std::uint32_t> grams = gramsOf(pattern);
+        std::vector<const std::vector<std::uint32_t>*> lists;
+        for (std::uint32_t gram : grams) {
+            auto found = postings.find(gram);
+            if (found != postings.end()) lists.push_back(&found->second);
+        }
+        std::sort(lists.begin(), lists.end(), [](auto* a, auto* b) { return a->size() < b->size(); });
+        int total = (int)grams.size();
+
+        std::vector<std::uint8_t> shared(entries.size(), 0);
+        for (const auto* list : lists) {
+            for (std::uint32_t id : *list) shared[id]++;
+        }
+
+        const std::uint8_t checked = 255; // Já conferido (Q <= 62)
+        std::vector<Match> matches;
+        DistanceRows rows;
+        for (int level = 0; level <= k; level++) {
+            // Todos os resultados a distância < level já foram achados
+            int closest = (int)std::count_if(matches.begin(), matches.end(),
+                [&](const Match& m) { return m.distance <= level; });
+            if (closest >= limit) break;
+
+            int threshold = std::max(1, total - 4 * level);
+            int scanned = std::min((int)lists.size(), total - threshold + 1);
+            for (int i = 0; i < scanned && closest < limit; i++) {
+                for (std::uint32_t id : *lists[i]) {
+                    if (shared[id] == checked || shared[id] < threshold || !entries[id].alive) continue;
+                    shared[id] = checked;
+
+                    const Entry& entry = entries[id];
+                    int distance = std::min(rows.substringDistance(pattern, entry.name, k),
+                                            rows.substringDistance(pattern, entry.email, k));
+                    if (distance > k) continue;
+
+                    int lengthGap = std::abs((int)entry.name.size() - (int)pattern.size());
+                    matches.push_back({distance, lengthGap, id});
+                    if (distance <= level && ++closest == limit) break;
+                }
+            }
+        }
+
+        // Mais próximos primeiro; no empate, nomes de tamanho mais parecido
+        int count = std::min(limit, (int)matches.size());
+        std::partial_sort(matches.begin(), matches.begin() + count, matches.end(),
+            [&](const Match& a, const Match& b) {
+                if (a.distance != b.distance) return a.distance < b.distance;
+                if (a.lengthGap != b.lengthGap) return a.lengthGap < b.lengthGap;
+                return entries[a.id].original < entries[b.id].original;
+            });
+        for (int i = 0; i < count; i++) {
+            visit(std::string_view(entries[matches[i].id].original), matches[i].distance);
+        }
+        return count;
+    }
+
+    // Distância usada na busca: menor distância Damerau entre pattern e um
+    // trecho de text, ou k + 1 se passar de k
+    static int distance(const std::string& pattern, const std::string& text, int k) {
+        DistanceRows rows;
+        return rows.substringDistance(pattern, text, k);
+    }
+
+private:
+    struct Entry {
+        std::string original; // Nome como está na agenda (chave)
+        std::string name;     // Nome dobrado
+        std::string email;    // Email dobrado
+        bool alive;
+    };
+
+    struct Match {
+        int distance;
+        int lengthGap;
+        std::uint32_t id;
+    };
+
+    // Linhas reaproveitadas entre os cálculos de distância de uma consulta
+    struct DistanceRows {
+        std::vector<int> previous2, previous, current;
+
+        // Menor distância Damerau (transposições adjacentes) entre pattern e
+        // algum trecho de text; para assim que toda a linha passa de k e
+        // então retorna k + 1
+        int substringDistance(const std::string& pattern, const std::string& text, int k) {
+            std::size_t n = text.size();
+            previous2.assign(n + 1, 0);
+            previous.assign(n + 1, 0); // Linha 0: o trecho pode começar em qualquer ponto
+            current.assign(n + 1, 0);
+
+            for (std::size_t i = 1; i <= pattern.size(); i++) {
+                current[0] = (int)i;
+                int rowMin = current[0];
+                for (std::size_t j = 1; j <= n; j++) {
+                    int cost = pattern[i - 1] == text[j - 1] ? 0 : 1;
+                    int best = std::min({previous[j] + 1, current[j - 1] + 1, previous[j - 1] + cost});
+                    if (i > 1 && j > 1 && pattern[i - 1] == text[j - 2] && pattern[i - 2] == text[j - 1]) {
+                        best = std::min(best, previous2[j - 2] + 1);
+                    }
+                    current[j] = best;
+                    rowMin = std::min(rowMin, best);
+                }
+                if (rowMin > k) return k + 1;
+                std::swap(previous2, previous);
+                std::swap(previous, current);
+            }
+            return std::min(k + 1, *std::min_element(previous.begin(), previous.end()));
+        }
+    };
+
+    // Trigramas distintos do texto, empacotados em 24 bits
+    static std::vector<std::uint32_t> gramsOf(const std::string& text) {
+        std::vector<std::uint32_t> grams;
+        for (std::size_t i = 0; i + 3 <= text.size(); i++) {
+            grams.push_back(((std::uint32_t)(unsigned char)text[i] << 16) |
+                            ((std::uint32_t)(unsigned char)text[i + 1] << 8) |
+                            (std::uint32_t)(unsigned char)text[i + 2]);
+        }
+        std::sort(grams.begin(), grams.end());
+        grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+        return grams;
+    }
+
+    // Ids só crescem, então as listas continuam ordenadas
+    void addGrams(std::uint32_t id) {
+        std::vector<std::uint32_t> grams = gramsOf(entries[id].name);
+        std::vector<std::uint32_t> emailGrams = gramsOf(entries[id].email);
+        grams.insert(grams.end(), emailGrams.begin(), emailGrams.end());
+        std::sort(grams.begin(), grams.end());
+        grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+        for (std::uint32_t gram : grams) {
+            postings[gram].push_back(id);
+        }
+    }
+
+    void discard(std::uint32_t id) {
+        entries[id].alive = false;
+        entries[id].name.clear();
+        entries[id].email.clear();
+        live--;
+    }
+
+    // Descartadas passaram da metade (depois de remove ou de trocar email)
+    void compactIfSparse() {
+        if (entries.size() > 64 && (std::size_t)live * 2 < entries.size()) compact();
+    }
+
+    // Renumera as entradas vivas e refaz as listas
+    void compact() {
+        std::vector<Entry> alive;
+        alive.reserve(live);
+        for (Entry& entry : entries) {
+            if (entry.alive) alive.push_back(std::move(entry));
+        }
+        entries = std::move(alive);
+        postings.clear();
+        idByName.clear();
+        for (std::uint32_t id = 0; id < entries.size(); id++) {
+            idByName[entries[id].original] = id;
+            addGrams(id);
+        }
+    }
+
+    std::vector<Entry> entries;
+    std::unordered_map<std::string, std::uint32_t> idByName;
+    std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> postings;
+    int live = 0;
+};
+
+#endif
\ No newline at end of file
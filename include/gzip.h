@@ -0,0 +1,307 @@
+#ifndef GZIP_H
+#define GZIP_H
+
+#include <algorithm>
+#include <cstdint>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Compressão gzip (RFC 1952 / deflate, RFC 1951) sem dependências, para os
+// arquivos estáticos do servidor: comprimidos uma vez e servidos muitas.
+// LZ77 com cadeias de hash (janela de 32 KB, casamento preguiçoso de um
+// passo) e um bloco com códigos de Huffman próprios da entrada.
+class Gzip {
+public:
+    static std::string compress(std::string_view input) {
+        std::string output = {'\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, '\xff'}; // Sem nome nem data
+        BitWriter bits(output);
+        writeBlock(bits, tokenize(input));
+        bits.flush();
+        appendLittleEndian(output, crc32(input));
+        appendLittleEndian(output, (std::uint32_t)input.size());
+        return output;
+    }
+
+    static std::uint32_t crc32(std::string_view data) {
+        static const std::vector<std::uint32_t> table = [] {
+            std::vector<std::uint32_t> t(256);
+            for (std::uint32_t i = 0; i < 256; i++) {
+                std::uint32_t c = i;
+                for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[i] = c;
+            }
+            return t;
+        }();
+        std::uint32_t crc = 0xFFFFFFFFu;
+        for (unsigned char c : data) crc = table[(crc ^ c) & 0xFF] ^ (crc >> 8);
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+private:
+    static constexpr int WindowSize = 32768;
+    static constexpr int MinMatch = 3;
+    static constexpr int MaxMatch = 258;
+    static constexpr int MaxChain = 128;
+    static constexpr int LazyLimit = 32; // Casamentos maiores não esperam o próximo
+
+    // Literal (distance 0) ou cópia de length bytes de distance atrás
+    struct Token {
+        std::uint16_t value;
+        std::uint16_t distance;
+    };
+
+    static constexpr std::uint16_t lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27,
+        31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static constexpr std::uint8_t lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+        2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static constexpr std::uint16_t distanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97,
+        129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static constexpr std::uint8_t distanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5,
+        6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    // Ordem em que os tamanhos do código dos tamanhos são gravados
+    static constexpr std::uint8_t codeLengthOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4,
+        12, 3, 13, 2, 14, 1, 15};
+
+    // Bits do menos para o mais significativo, como o deflate pede
+    class BitWriter {
+    public:
+        explicit BitWriter(std::string& output) : output(output) {}
+
+        void put(std::uint32_t value, int count) {
+            buffer |= (std::uint64_t)value << used;
+            used += count;
+            while (used >= 8) {
+                output += (char)(buffer & 0xFF);
+                buffer >>= 8;
+                used -= 8;
+            }
+        }
+
+        void flush() {
+            if (used > 0) output += (char)(buffer & 0xFF);
+            buffer = 0;
+            used = 0;
+        }
+
+    private:
+        std::string& output;
+        std::uint64_t buffer = 0;
+        int used = 0;
+    };
+
+    // Códigos canônicos a partir dos tamanhos, já invertidos para put()
+    struct HuffmanCode {
+        std::vector<std::uint8_t> lengths;
+        std::vector<std::uint16_t> codes;
+
+        HuffmanCode(std::vector<std::uint32_t> frequencies, int maxBits) {
+            lengths = buildLengths(std::move(frequencies), maxBits);
+            codes.assign(lengths.size(), 0);
+            std::vector<int> count(maxBits + 1, 0), next(maxBits + 2, 0);
+            for (std::uint8_t length : lengths) count[length]++;
+            count[0] = 0;
+            for (int bits = 1; bits <= maxBits; bits++) next[bits + 1] = (next[bits] + count[bits]) << 1;
+            for (std::size_t symbol = 0; symbol < lengths.size(); symbol++) {
+                int length = lengths[symbol];
+                if (length == 0) continue;
+                std::uint16_t code = (std::uint16_t)next[length]++, reversed = 0;
+                for (int i = 0; i < length; i++) reversed |= ((code >> i) & 1) << (length - 1 - i);
+                codes[symbol] = reversed;
+            }
+        }
+
+        void write(BitWriter& bits, int symbol) const {
+            bits.put(codes[symbol], lengths[symbol]);
+        }
+    };
+
+    // Tamanhos de Huffman limitados a maxBits: se a árvore passar do
+    // limite, as frequências são divididas por 2 e a árvore é refeita
+    static std::vector<std::uint8_t> buildLengths(std::vector<std::uint32_t> frequencies, int maxBits) {
+        // Ao menos dois símbolos, para o código ser completo
+        int used = (int)std::count_if(frequencies.begin(), frequencies.end(), [](std::uint32_t f) { return f > 0; });
+        for (std::size_t i = 0; used < 2 && i < frequencies.size(); i++) {
+            if (frequencies[i] == 0) {
+                frequencies[i] = 1;
+                used++;
+            }
+        }
+
+        std::vector<std::uint8_t> lengths(frequencies.size(), 0);
+        while (true) {
+            // Nós 0..n-1 são folhas; os internos vêm depois
+            std::vector<int> parent(2 * frequencies.size(), -1);
+            using Item = std::pair<std::uint64_t, int>;
+            std::priority_queue<Item, std::vector<Item>, std::greater<Item>> heap;
+            for (std::size_t i = 0; i < frequencies.size(); i++) {
+                if (frequencies[i] > 0) heap.push({frequencies[i], (int)i});
+            }
+            int nextNode = (int)frequencies.size();
+            while (heap.size() > 1) {
+                Item a = heap.top();
+                heap.pop();
+                Item b = heap.top();
+                heap.pop();
+                parent[a.second] = parent[b.second] = nextNode;
+                heap.push({a.first + b.first, nextNode++});
+            }
+
+            int longest = 0;
+            for (std::size_t i = 0; i < frequencies.size(); i++) {
+                if (frequencies[i] == 0) continue;
+                int depth = 0;
+                for (int node = (int)i; parent[node] >= 0; node = parent[node]) depth++;
+                lengths[i] = (std::uint8_t)depth;
+                longest = std::max(longest, depth);
+            }
+            if (longest <= maxBits) return lengths;
+            for (std::uint32_t& f : frequencies) {
+                if (f > 0) f = (f >> 1) | 1;
+            }
+        }
+    }
+
+    static std::vector<Token> tokenize(std::string_view input) {
+        const unsigned char* data = (const unsigned char*)input.data();
+        const int n = (int)input.size();
+        std::vector<int> head(1 << 15, -1), previous(WindowSize, -1);
+        std::vector<Token> tokens;
+        tokens.reserve(input.size() / 2 + 1);
+        int inserted = 0;
+
+        auto hash = [&](int i) { return ((data[i] << 10) ^ (data[i + 1] << 5) ^ data[i + 2]) & 0x7FFF; };
+        // Posições < end entram nas cadeias, cada uma uma única vez
+        auto insertUpTo = [&](int end) {
+            for (; inserted < end && inserted + MinMatch <= n; inserted++) {
+                int h = hash(inserted);
+                previous[inserted & (WindowSize - 1)] = head[h];
+                head[h] = inserted;
+            }
+        };
+        auto longestMatch = [&](int i) {
+            std::pair<int, int> best{0, 0}; // Tamanho, distância
+            if (i + MinMatch > n) return best;
+            int limit = std::min(MaxMatch, n - i);
+            int chain = MaxChain;
+            for (int candidate = head[hash(i)]; candidate >= 0 && i - candidate <= WindowSize && chain-- > 0;
+                 candidate = previous[candidate & (WindowSize - 1)]) {
+                if (data[candidate + best.first] != data[i + best.first]) continue;
+                int length = 0;
+                while (length < limit && data[candidate + length] == data[i + length]) length++;
+                if (length > best.first) {
+                    best = {length, i - candidate};
+                    if (length == limit) break;
+                }
+            }
+            return best;
+        };
+
+        for (int i = 0; i < n;) {
+            insertUpTo(i);
+            std::pair<int, int> match = longestMatch(i);
+            if (match.first >= MinMatch && match.first < LazyLimit) {
+                // Um literal agora pode render um casamento maior em seguida
+                insertUpTo(i + 1);
+                if (longestMatch(i + 1).first > match.first) match.first = 0;
+            }
+            if (match.first >= MinMatch) {
+                tokens.push_back({(std::uint16_t)match.first, (std::uint16_t)match.second});
+                i += match.first;
+            } else {
+                tokens.push_back({data[i], 0});
+                i++;
+            }
+        }
+        return tokens;
+    }
+
+    static int lengthSymbol(int length) {
+        return (int)(std::upper_bound(lengthBase, lengthBase + 29, length) - lengthBase) - 1;
+    }
+
+    static int distanceSymbol(int distance) {
+        return (int)(std::upper_bound(distanceBase, distanceBase + 30, distance) - distanceBase) - 1;
+    }
+
+    // Um bloco final com códigos dinâmicos (BTYPE = 2)
+    static void writeBlock(BitWriter& bits, const std::vector<Token>& tokens) {
+        std::vector<std::uint32_t> literalFrequencies(286, 0), distanceFrequencies(30, 0);
+        for (const Token& token : tokens) {
+            if (token.distance == 0) {
+                literalFrequencies[token.value]++;
+            } else {
+                literalFrequencies[257 + lengthSymbol(token.value)]++;
+                distanceFrequencies[distanceSymbol(token.distance)]++;
+            }
+        }
+        literalFrequencies[256] = 1; // Fim do bloco
+        HuffmanCode literals(literalFrequencies, 15), distances(distanceFrequencies, 15);
+
+        int literalCount = 286, distanceCount = 30;
+        while (literalCount > 257 && literals.lengths[literalCount - 1] == 0) literalCount--;
+        while (distanceCount > 1 && distances.lengths[distanceCount - 1] == 0) distanceCount--;
+
+        // Tamanhos dos dois códigos em sequência, com repetições (16, 17, 18)
+        std::vector<std::uint8_t> all(literals.lengths.begin(), literals.lengths.begin() + literalCount);
+        all.insert(all.end(), distances.lengths.begin(), distances.lengths.begin() + distanceCount);
+        std::vector<std::pair<int, int>> runs; // Símbolo, bits extras
+        for (std::size_t i = 0; i < all.size();) {
+            int value = all[i], run = 1;
+            while (i + run < all.size() && all[i + run] == value) run++;
+            i += run;
+            if (value == 0) {
+                for (; run >= 11; run -= std::min(run, 138)) runs.push_back({18, std::min(run, 138) - 11});
+                if (run >= 3) {
+                    runs.push_back({17, run - 3});
+                    run = 0;
+                }
+            } else {
+                runs.push_back({value, 0});
+                for (run--; run >= 3; run -= std::min(run, 6)) runs.push_back({16, std::min(run, 6) - 3});
+            }
+            for (; run > 0; run--) runs.push_back({value, 0});
+        }
+
+        std::vector<std::uint32_t> codeLengthFrequencies(19, 0);
+        for (const auto& run : runs) codeLengthFrequencies[run.first]++;
+        HuffmanCode codeLengths(codeLengthFrequencies, 7);
+        int codeLengthCount = 19;
+        while (codeLengthCount > 4 && codeLengths.lengths[codeLengthOrder[codeLengthCount - 1]] == 0) codeLengthCount--;
+
+        bits.put(1, 1); // Último bloco
+        bits.put(2, 2);
+        bits.put(literalCount - 257, 5);
+        bits.put(distanceCount - 1, 5);
+        bits.put(codeLengthCount - 4, 4);
+        for (int i = 0; i < codeLengthCount; i++) bits.put(codeLengths.lengths[codeLengthOrder[i]], 3);
+        for (const auto& run : runs) {
+            codeLengths.write(bits, run.first);
+            if (run.first == 16) bits.put(run.second, 2);
+            if (run.first == 17) bits.put(run.second, 3);
+            if (run.first == 18) bits.put(run.second, 7);
+        }
+
+        for (const Token& token : tokens) {
+            if (token.distance == 0) {
+                literals.write(bits, token.value);
+                continue;
+            }
+            int length = lengthSymbol(token.value);
+            literals.write(bits, 257 + length);
+            bits.put(token.value - lengthBase[length], lengthExtra[length]);
+            int distance = distanceSymbol(token.distance);
+            distances.write(bits, distance);
+            bits.put(token.distance - distanceBase[distance], distanceExtra[distance]);
+        }
+        literals.write(bits, 256);
+    }
+
+    static void appendLittleEndian(std::string& output, std::uint32_t value) {
+        for (int i = 0; i < 4; i++) output += (char)((value >> (8 * i)) & 0xFF);
+    }
+};
+
+#endif
\ No newline at end of file
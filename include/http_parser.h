@@ -0,0 +1,315 @@
+#ifndef HTTP_PARSER_H
+#define HTTP_PARSER_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Requisição HTTP/1.x já separada em partes; body é o corpo decodificado
+// (sem Transfer-Encoding).
+struct HttpRequest {
+    std::string method;
+    std::string target;
+    std::string version;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+
+    // Valor do cabeçalho (nome sem distinção de maiúsculas), ou nullptr
+    const std::string* header(std::string_view name) const {
+        for (const auto& header : headers) {
+            if (equalsIgnoreCase(header.first, name)) return &header.second;
+        }
+        return nullptr;
+    }
+
+    // HTTP/1.1 mantém a conexão, a não ser com "Connection: close";
+    // HTTP/1.0 só com "Connection: keep-alive"
+    bool keepAlive() const {
+        const std::string* connection = header("connection");
+        if (version == "HTTP/1.1") return !connection || !equalsIgnoreCase(*connection, "close");
+        return connection && equalsIgnoreCase(*connection, "keep-alive");
+    }
+
+    static bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+        if (a.size() != b.size()) return false;
+        for (std::size_t i = 0; i < a.size(); i++) {
+            if (std::tolower((unsigned char)a[i]) != std::tolower((unsigned char)b[i])) return false;
+        }
+        return true;
+    }
+};
+
+// Parser incremental: os bytes chegam em pedaços por append() e next()
+// devolve cada requisição completa, na ordem, continuando de onde a
+// leitura anterior parou (sem reler o buffer). Aceita corpo por
+// Content-Length ou chunked e várias requisições seguidas no mesmo buffer
+// (pipelining).
+class HttpRequestParser {
+public:
+    enum class Status { NeedMore, Complete, Error };
+
+    static constexpr std::size_t MaxHeaderSize = 64 * 1024;
+
+    explicit HttpRequestParser(std::size_t maxBodySize = 1 << 20) : maxBodySize(maxBodySize) {}
+
+    void append(const char* data, std::size_t size) {
+        buffer.append(data, size);
+    }
+
+    // Bytes recebidos que ainda não viraram requisição
+    std::size_t pending() const {
+        return buffer.size() - start;
+    }
+
+    // Próxima requisição completa. Depois de Error o parser não avança
+    // mais: errorStatus() diz a resposta (400, 413, 431 ou 501) e a
+    // conexão deve ser fechada.
+    Status next(HttpRequest& request) {
+        if (error) return Status::Error;
+
+        while (true) {
+            switch (state) {
+            case State::Head: {
+                // Linhas vazias entre requisições são ignoradas (RFC 9112)
+                while (buffer.compare(start, 2, "\r\n") == 0) start += 2;
+                if (cursor < start) cursor = start;
+                std::size_t from = cursor > start + 3 ? cursor - 3 : start;
+                std::size_t end = buffer.find("\r\n\r\n", from);
+                if (end == std::string::npos) {
+                    cursor = buffer.size();
+                    return pending() > MaxHeaderSize ? fail(431) : Status::NeedMore;
+                }
+                if (end - start > MaxHeaderSize) return fail(431);
+                if (!parseHead(end)) return Status::Error;
+                cursor = end + 4;
+                break;
+            }
+            case State::Body:
+                if (buffer.size() - cursor < remaining) return Status::NeedMore;
+                current.body.append(buffer, cursor, remaining);
+                cursor += remaining;
+                state = State::Done;
+                break;
+            case State::ChunkSize: {
+                std::size_t end = buffer.find("\r\n", cursor);
+                if (end == std::string::npos) {
+                    return buffer.size() - cursor > 1024 ? fail(400) : Status::NeedMore;
+                }
+                std::size_t size = 0, digits = 0;
+                for (std::size_t i = cursor; i < end && buffer[i] != ';'; i++, digits++) {
+                    int value = hexValue(buffer[i]);
+                    if (value < 0 || size > maxBodySize) return fail(400);
+                    size = size * 16 + value;
+                }
+                if (digits == 0) return fail(400);
+                if (current.body.size() + size > maxBodySize) return fail(413);
+                cursor = end + 2;
+                remaining = size;
+                state = size == 0 ? State::Trailers : State::ChunkData;
+                break;
+            }
+            case State::ChunkData:
+                if (buffer.size() - cursor < remaining + 2) return Status::NeedMore;
+                if (buffer.compare(cursor + remaining, 2, "\r\n") != 0) return fail(400);
+                current.body.append(buffer, cursor, remaining);
+                cursor += remaining + 2;
+                state = State::ChunkSize;
+                break;
+            case State::Trailers: {
+                // Cabeçalhos finais são descartados; termina na linha vazia
+                std::size_t end = buffer.find("\r\n", cursor);
+                if (end == std::string::npos) {
+                    return buffer.size() - cursor > MaxHeaderSize ? fail(431) : Status::NeedMore;
+                }
+                bool last = end == cursor;
+                cursor = end + 2;
+                if (last) state = State::Done;
+                break;
+            }
+            case State::Done:
+                finish(request);
+                return Status::Complete;
+            }
+        }
+    }
+
+    // O cliente pediu "Expect: 100-continue" e espera a resposta provisória
+    // antes de mandar o corpo; verdadeiro uma vez por requisição
+    bool takeContinueRequest() {
+        bool requested = continueRequested;
+        continueRequested = false;
+        return requested;
+    }
+
+    int errorStatus() const {
+        return error;
+    }
+
+private:
+    enum class State { Head, Body, ChunkSize, ChunkData, Trailers, Done };
+
+    static int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    Status fail(int status) {
+        error = status;
+        return Status::Error;
+    }
+
+    bool reject(int status) {
+        error = status;
+        return false;
+    }
+
+    // Linha de requisição e cabeçalhos em [start, end); escolhe como ler o corpo
+    bool parseHead(std::size_t end) {
+        current = HttpRequest();
+        std::size_t lineEnd = buffer.find("\r\n", start);
+        std::string_view line(buffer.data() + start, lineEnd - start);
+        std::size_t space1 = line.find(' ');
+        std::size_t space2 = line.rfind(' ');
+        if (space1 == std::string_view::npos || space1 == space2) return reject(400);
+        current.method = std::string(line.substr(0, space1));
+        current.target = std::string(line.substr(space1 + 1, space2 - space1 - 1));
+        current.version = std::string(line.substr(space2 + 1));
+        if (current.version != "HTTP/1.1" && current.version != "HTTP/1.0") return reject(400);
+
+        for (std::size_t pos = lineEnd + 2; pos < end;) {
+            std::size_t next = buffer.find("\r\n", pos);
+            std::string_view header(buffer.data() + pos, next - pos);
+            std::size_t colon = header.find(':');
+            if (colon == std::string_view::npos || colon == 0) return reject(400);
+            std::string_view value = header.substr(colon + 1);
+            while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) value.remove_prefix(1);
+            while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) value.remove_suffix(1);
+            current.headers.emplace_back(std::string(header.substr(0, colon)), std::string(value));
+            pos = next + 2;
+        }
+
+        const std::string* encoding = current.header("transfer-encoding");
+        const std::string* length = current.header("content-length");
+        const std::string* expect = current.header("expect");
+        if (encoding) {
+            if (!HttpRequest::equalsIgnoreCase(*encoding, "chunked")) return reject(501);
+            state = State::ChunkSize;
+        } else if (length) {
+            remaining = 0;
+            if (length->empty()) return reject(400);
+            for (char c : *length) {
+                if (c < '0' || c > '9') return reject(400);
+                remaining = remaining * 10 + (c - '0');
+                if (remaining > maxBodySize) return reject(413);
+            }
+            state = State::Body;
+        } else {
+            state = State::Done;
+        }
+        continueRequested = state != State::Done && expect && HttpRequest::equalsIgnoreCase(*expect, "100-continue");
+        return true;
+    }
+
+    // Entrega a requisição e descarta os bytes já consumidos
+    void finish(HttpRequest& request) {
+        request = std::move(current);
+
+        start = cursor;
+        state = State::Head;
+        continueRequested = false;
+        // Compacta quando a parte consumida domina o buffer
+        if (start > 4096 && start * 2 > buffer.size()) {
+            buffer.erase(0, start);
+            cursor -= start;
+            start = 0;
+        }
+    }
+
+    std::string buffer;
+    std::size_t start = 0;  // Início da requisição atual
+    std::size_t cursor = 0; // Até onde já foi lido
+    std::size_t remaining = 0;
+    std::size_t maxBodySize;
+    State state = State::Head;
+    HttpRequest current;
+    bool continueRequested = false;
+    int error = 0;
+};
+
+// Resposta de um handler. Normalmente a mensagem inteira fica em text; um
+// corpo imutável e compartilhado (arquivo em cache) pode vir em body, e
+// então text tem só a linha de status e os cabeçalhos. O servidor envia as
+// duas partes juntas, sem copiar o corpo.
+struct HttpResponse {
+    std::string text;
+    std::shared_ptr<const std::string> body;
+
+    HttpResponse(std::string text = "") : text(std::move(text)) {}
+    HttpResponse(const char* text) : text(text) {}
+    HttpResponse(std::string head, std::shared_ptr<const std::string> body)
+        : text(std::move(head)), body(std::move(body)) {}
+
+    std::size_t size() const {
+        return text.size() + (body ? body->size() : 0);
+    }
+};
+
+// Linha de status e cabeçalhos de head (sem a linha vazia final) com
+// Content-Length de bodyLength e o Connection decidido pelo servidor,
+// terminados pela linha vazia. 204 e 304 não têm corpo nem Content-Length.
+inline std::string finalizeHead(std::string_view head, std::size_t bodyLength, bool keepAlive) {
+    std::string result;
+    result.reserve(head.size() + 64);
+    bool hasLength = false;
+    std::size_t lineStart = 0;
+    while (lineStart < head.size()) {
+        std::size_t lineEnd = std::min(head.find("\r\n", lineStart), head.size());
+        std::string_view line = head.substr(lineStart, lineEnd - lineStart);
+        std::string_view name = line.substr(0, line.find(':'));
+        if (lineStart > 0 && HttpRequest::equalsIgnoreCase(name, "content-length")) hasLength = true;
+        if (lineStart == 0 || !HttpRequest::equalsIgnoreCase(name, "connection")) {
+            result.append(line);
+            result += "\r\n";
+        }
+        lineStart = lineEnd + 2;
+    }
+    std::string_view status = head.substr(std::min<std::size_t>(9, head.size()), 3);
+    bool bodiless = status == "204" || status == "304";
+    if (!hasLength && !bodiless) {
+        result += "Content-Length: " + std::to_string(bodyLength) + "\r\n";
+    }
+    result += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    return result;
+}
+
+// Ajusta os cabeçalhos de conexão da resposta do handler: garante
+// Content-Length (necessário para a conexão continuar aberta) e troca
+// qualquer Connection pelo que o servidor decidiu
+inline std::string finalizeResponse(const std::string& response, bool keepAlive) {
+    std::size_t headerEnd = std::min(response.find("\r\n\r\n"), response.size());
+    std::size_t bodyStart = std::min(headerEnd + 4, response.size());
+    std::string result = finalizeHead(std::string_view(response).substr(0, headerEnd),
+                                      response.size() - bodyStart, keepAlive);
+    result.append(response, bodyStart, std::string::npos);
+    return result;
+}
+
+// O mesmo para HttpResponse; com body compartilhado só text é reescrito
+inline void finalizeResponse(HttpResponse& response, bool keepAlive) {
+    if (!response.body) {
+        response.text = finalizeResponse(response.text, keepAlive);
+        return;
+    }
+    std::size_t headerEnd = std::min(response.text.find("\r\n\r\n"), response.text.size());
+    response.text = finalizeHead(std::string_view(response.text).substr(0, headerEnd),
+                                 response.body->size(), keepAlive);
+}
+
+#endif
\ No newline at end of file
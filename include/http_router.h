@@ -0,0 +1,185 @@
+#ifndef HTTP_ROUTER_H
+#define HTTP_ROUTER_H
+
+#include "http_parser.h"
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Requisição já roteada: o caminho, os parâmetros do caminho (segmentos
+// ":nome" do padrão) e os da query string, decodificados uma vez só
+struct RouteRequest {
+    const HttpRequest& http;
+    std::string_view path;
+    std::vector<std::pair<std::string_view, std::string>> pathParams;
+    std::vector<std::pair<std::string, std::string>> queryParams;
+
+    // Parâmetro ":name" do caminho, ou vazio
+    std::string param(std::string_view name) const {
+        for (const auto& param : pathParams) {
+            if (param.first == name) return param.second;
+        }
+        return "";
+    }
+
+    // Primeiro valor de name na query string, ou vazio
+    std::string query(std::string_view name) const {
+        for (const auto& param : queryParams) {
+            if (param.first == name) return param.second;
+        }
+        return "";
+    }
+
+    const std::string& body() const {
+        return http.body;
+    }
+};
+
+// Tabela de rotas em trie de segmentos do caminho: "/api/contacts/:name"
+// vira api -> contacts -> :name, e cada nó guarda os handlers por método.
+// A trie é montada uma vez (add) e o despacho percorre o caminho uma vez,
+// O(tamanho do caminho), sem olhar cabeçalhos nem corpo. Um segmento fixo
+// tem preferência sobre ":nome" no mesmo nível, sem voltar atrás.
+class HttpRouter {
+public:
+    using Handler = std::function<HttpResponse(const RouteRequest&)>;
+
+    HttpRouter() : nodes(1) {}
+
+    void add(std::string_view method, std::string_view pattern, Handler handler) {
+        int node = 0;
+        forEachSegment(pattern, [&](std::string_view segment) {
+            if (!segment.empty() && segment[0] == ':') {
+                if (nodes[node].paramChild < 0) {
+                    nodes[node].paramChild = (int)nodes.size();
+                    nodes.emplace_back();
+                    nodes.back().paramName = std::string(segment.substr(1));
+                }
+                node = nodes[node].paramChild;
+            } else {
+                auto found = nodes[node].children.find(segment);
+                if (found == nodes[node].children.end()) {
+                    int child = (int)nodes.size();
+                    nodes[node].children.emplace(std::string(segment), child);
+                    nodes.emplace_back();
+                    node = child;
+                } else {
+                    node = found->second;
+                }
+            }
+            return true;
+        });
+        nodes[node].routes.emplace_back(std::string(method), std::move(handler));
+    }
+
+    // Resposta do handler da rota; 404 se o caminho não existe e 405 (com
+    // Allow) se existe mas não para esse método
+    HttpResponse dispatch(const HttpRequest& request) const {
+        std::string_view target = request.target;
+        std::size_t queryStart = target.find('?');
+        RouteRequest route{request, target.substr(0, queryStart), {}, {}};
+
+        int node = 0;
+        bool matched = !route.path.empty() && route.path[0] == '/' &&
+            forEachSegment(route.path, [&](std::string_view segment) {
+                auto found = nodes[node].children.find(segment);
+                if (found != nodes[node].children.end()) {
+                    node = found->second;
+                } else if (nodes[node].paramChild >= 0 && !segment.empty()) {
+                    node = nodes[node].paramChild;
+                    route.pathParams.emplace_back(nodes[node].paramName, decode(segment, false));
+                } else {
+                    return false;
+                }
+                return true;
+            });
+        if (!matched || nodes[node].routes.empty()) {
+            return "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\n\r\n404 - Pagina nao encontrada";
+        }
+
+        std::string allow;
+        for (const auto& entry : nodes[node].routes) {
+            if (entry.first == request.method) {
+                if (queryStart != std::string_view::npos) {
+                    route.queryParams = parseQuery(target.substr(queryStart + 1));
+                }
+                return entry.second(route);
+            }
+            allow += (allow.empty() ? "" : ", ") + entry.first;
+        }
+        return "HTTP/1.1 405 Method Not Allowed\r\nAllow: " + allow +
+               "\r\nContent-Type: text/plain\r\n\r\n405 - Metodo nao permitido";
+    }
+
+    // Pares chave=valor decodificados; itens sem '=' são ignorados
+    static std::vector<std::pair<std::string, std::string>> parseQuery(std::string_view query) {
+        std::vector<std::pair<std::string, std::string>> params;
+        while (!query.empty()) {
+            std::size_t end = query.find('&');
+            std::string_view item = query.substr(0, end);
+            std::size_t eq = item.find('=');
+            if (eq != std::string_view::npos) {
+                params.emplace_back(decode(item.substr(0, eq), true), decode(item.substr(eq + 1), true));
+            }
+            if (end == std::string_view::npos) break;
+            query.remove_prefix(end + 1);
+        }
+        return params;
+    }
+
+    // Decodifica %XX; '+' vira espaço só na query string
+    static std::string decode(std::string_view input, bool plusAsSpace) {
+        std::string output;
+        output.reserve(input.size());
+        for (std::size_t i = 0; i < input.size(); i++) {
+            int high, low;
+            if (input[i] == '+' && plusAsSpace) {
+                output += ' ';
+            } else if (input[i] == '%' && i + 2 < input.size() &&
+                       (high = hexValue(input[i + 1])) >= 0 && (low = hexValue(input[i + 2])) >= 0) {
+                output += (char)(high * 16 + low);
+                i += 2;
+            } else {
+                output += input[i];
+            }
+        }
+        return output;
+    }
+
+private:
+    struct Node {
+        std::map<std::string, int, std::less<>> children;
+        int paramChild = -1;
+        std::string paramName;
+        std::vector<std::pair<std::string, Handler>> routes;
+    };
+
+    static int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    // Segmentos entre '/' depois da barra inicial ("/" não tem nenhum);
+    // para no primeiro em que visit retorna false
+    template<typename Visitor>
+    static bool forEachSegment(std::string_view path, Visitor visit) {
+        if (!path.empty() && path[0] == '/') path.remove_prefix(1);
+        while (!path.empty()) {
+            std::size_t end = path.find('/');
+            if (!visit(path.substr(0, end))) return false;
+            if (end == std::string_view::npos) break;
+            path.remove_prefix(end + 1);
+            if (path.empty() && !visit(path)) return false; // Barra final
+        }
+        return true;
+    }
+
+    std::vector<Node> nodes;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,468 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include "http_parser.h"
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Transporte HTTP do servidor web: lê as requisições com
+// HttpRequestParser, chama o handler e envia as respostas. Dois backends:
+//   POSIX (Linux): sockets não bloqueantes e epoll com N threads; cada
+//     thread tem o próprio socket de escuta (SO_REUSEPORT, o kernel
+//     distribui as conexões) e o próprio epoll, sem estado compartilhado.
+//     Conexões persistentes (keep-alive) com pipelining, fechadas depois
+//     de 15 s sem atividade (setIdleTimeout). As respostas ficam numa
+//     fila e saem com uma chamada para várias (sendmsg com iovec), com os
+//     corpos compartilhados enviados direto do cache, sem cópia.
+//   Winsock: laço bloqueante, uma conexão por vez e uma requisição por
+//     conexão (manter a conexão aberta travaria os outros clientes).
+//     Padrão no Windows; -DAGENDA_WINSOCK força este backend.
+#if defined(_WIN32) || defined(AGENDA_WINSOCK)
+#define HTTP_SERVER_WINSOCK 1
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <deque>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <unordered_map>
+#endif
+
+class HttpServer {
+public:
+    // Recebe a requisição inteira e retorna a resposta inteira. No backend
+    // POSIX é chamado por várias threads ao mesmo tempo.
+    using Handler = std::function<HttpResponse(const HttpRequest& request)>;
+
+    // Padrão de setMaxBodySize; corpos maiores recebem 413
+    static constexpr std::size_t MaxBodySize = 1 << 20;
+    // Acima disso em respostas pendentes, a conexão para de ser lida até o
+    // cliente consumir (pipelining sem limite acumularia memória)
+    static constexpr std::size_t MaxPendingOutput = 1 << 20;
+    // Bytes lidos por evento; o resto fica para a próxima volta do epoll,
+    // sem que um cliente rápido prenda as outras conexões do worker
+    static constexpr std::size_t MaxReadPerEvent = 32 * 1024;
+
+    explicit HttpServer(Handler handler) : handler(std::move(handler)) {}
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    ~HttpServer() {
+        for (auto socket : listenSockets) {
+            closeSocket(socket);
+        }
+#ifdef HTTP_SERVER_WINSOCK
+        WSACleanup();
+#endif
+    }
+
+    // Cada conexão pode guardar um corpo desse tamanho até a requisição
+    // terminar; aumente só se algum endpoint precisar (ex.: lotes)
+    void setMaxBodySize(std::size_t size) {
+        maxBodySize = size;
+    }
+
+    // Conexões ociosas por mais que isso são fechadas (só POSIX)
+    void setIdleTimeout(std::chrono::milliseconds timeout) {
+        idleTimeout = timeout;
+    }
+
+    // Abre a porta; threads <= 0 usa uma por núcleo (ignorado no Winsock)
+    bool start(int port, int threads = 0) {
+#ifdef HTTP_SERVER_WINSOCK
+        (void)threads;
+        WSADATA wsaData;
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+            std::cerr << "Falha ao inicializar Winsock" << std::endl;
+            return false;
+        }
+        return openListener(port);
+#else
+        if (threads <= 0) threads = (int)std::thread::hardware_concurrency();
+        if (threads <= 0) threads = 1;
+        for (int i = 0; i < threads; i++) {
+            if (!openListener(port)) return false;
+        }
+        return true;
+#endif
+    }
+
+    int threadCount() const {
+        return (int)listenSockets.size();
+    }
+
+    // Atende para sempre
+    void run() {
+#ifdef HTTP_SERVER_WINSOCK
+        acceptLoop(listenSockets[0]);
+#else
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < listenSockets.size(); i++) {
+            workers.emplace_back([this, i] { eventLoop(listenSockets[i]); });
+        }
+        eventLoop(listenSockets[0]);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+#endif
+    }
+
+private:
+#ifdef HTTP_SERVER_WINSOCK
+    using Socket = SOCKET;
+    static constexpr Socket NoSocket = INVALID_SOCKET;
+
+    static void closeSocket(Socket socket) {
+        closesocket(socket);
+    }
+#else
+    using Socket = int;
+    static constexpr Socket NoSocket = -1;
+
+    static void closeSocket(Socket socket) {
+        close(socket);
+    }
+#endif
+
+    bool openListener(int port) {
+        Socket listener = socket(AF_INET, SOCK_STREAM, 0);
+        if (listener == NoSocket) {
+            std::cerr << "Erro ao criar socket" << std::endl;
+            return false;
+        }
+        listenSockets.push_back(listener);
+
+#ifndef HTTP_SERVER_WINSOCK
+        int on = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        if (setsockopt(listener, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0) {
+            std::cerr << "SO_REUSEPORT indisponível" << std::endl;
+            return false;
+        }
+        fcntl(listener, F_SETFL, fcntl(listener, F_GETFL) | O_NONBLOCK);
+#endif
+
+        sockaddr_in serverAddr;
+        std::memset(&serverAddr, 0, sizeof(serverAddr));
+        serverAddr.sin_family = AF_INET;
+        serverAddr.sin_addr.s_addr = INADDR_ANY;
+        serverAddr.sin_port = htons(port);
+
+        if (bind(listener, (sockaddr*)&serverAddr, sizeof(serverAddr)) != 0) {
+            std::cerr << "Erro no bind" << std::endl;
+            return false;
+        }
+        if (listen(listener, SOMAXCONN) != 0) {
+            std::cerr << "Erro no listen" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Resposta do handler, ou 500 se ele lançar exceção
+    HttpResponse respond(const HttpRequest& request) {
+        try {
+            return handler(request);
+        } catch (const std::exception& e) {
+            return "HTTP/1.1 500 Internal Server Error\r\nContent-Type: text/plain\r\n\r\nErro interno: " +
+                   std::string(e.what());
+        }
+    }
+
+    // Resposta para requisição que o parser recusou
+    static std::string errorResponse(int status) {
+        const char* reason = status == 413 ? "Payload Too Large" :
+                             status == 431 ? "Request Header Fields Too Large" :
+                             status == 501 ? "Not Implemented" : "Bad Request";
+        return finalizeResponse("HTTP/1.1 " + std::to_string(status) + " " + reason +
+                                "\r\nContent-Type: text/plain\r\n\r\n" + reason, false);
+    }
+
+#ifdef HTTP_SERVER_WINSOCK
+    static bool sendAll(Socket client, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            int n = send(client, data.data() + sent, (int)(data.size() - sent), 0);
+            if (n <= 0) return false;
+            sent += n;
+        }
+        return true;
+    }
+
+    void acceptLoop(Socket listener) {
+        while (true) {
+            Socket client = accept(listener, NULL, NULL);
+            if (client == INVALID_SOCKET) {
+                std::cerr << "Erro no accept" << std::endl;
+                continue;
+            }
+
+            HttpRequestParser parser(maxBodySize);
+            HttpRequest request;
+            HttpRequestParser::Status status = HttpRequestParser::Status::NeedMore;
+            char buffer[16384];
+            while (status == HttpRequestParser::Status::NeedMore) {
+                int received = recv(client, buffer, sizeof(buffer), 0);
+                if (received <= 0) break;
+                parser.append(buffer, received);
+                status = parser.next(request);
+                if (parser.takeContinueRequest()) sendAll(client, "HTTP/1.1 100 Continue\r\n\r\n");
+            }
+
+            if (status == HttpRequestParser::Status::Complete) {
+                HttpResponse response = respond(request);
+                finalizeResponse(response, false);
+                if (sendAll(client, response.text) && response.body) sendAll(client, *response.body);
+            } else if (status == HttpRequestParser::Status::Error) {
+                sendAll(client, errorResponse(parser.errorStatus()));
+            }
+            closesocket(client);
+        }
+    }
+#else
+    using Clock = std::chrono::steady_clock;
+
+    struct Connection {
+        explicit Connection(std::size_t maxBodySize) : parser(maxBodySize) {}
+
+        HttpRequestParser parser;
+        std::deque<HttpResponse> output;
+        size_t sent = 0;          // Bytes já enviados de output.front()
+        size_t pendingOutput = 0; // Bytes em output ainda não enviados
+        bool closeAfterWrite = false; // Última resposta já enfileirada
+        bool peerClosed = false;
+        unsigned interest = EPOLLIN;
+        Clock::time_point lastActivity = Clock::now();
+    };
+
+    // Uma thread: aceita do próprio socket de escuta e atende suas conexões
+    void eventLoop(Socket listener) {
+        int epoll = epoll_create1(0);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = listener;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &event);
+
+        std::unordered_map<int, Connection> connections;
+        // Descritor de reserva para quando acabam os descritores (acceptAll)
+        int spare = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        epoll_event events[64];
+        Clock::time_point lastSweep = Clock::now();
+        while (true) {
+            int ready = epoll_wait(epoll, events, 64, 1000);
+            if (ready < 0 && errno != EINTR) break;
+
+            for (int i = 0; i < ready; i++) {
+                int fd = events[i].data.fd;
+                if (fd == listener) {
+                    acceptAll(epoll, listener, connections, spare);
+                    continue;
+                }
+
+                auto found = connections.find(fd);
+                if (found == connections.end()) continue;
+                if (!serve(epoll, fd, found->second, events[i].events)) {
+                    connections.erase(found);
+                    close(fd); // Também sai do epoll
+                }
+            }
+
+            // Fecha as conexões ociosas (keep-alive esquecido, cliente lento)
+            Clock::time_point now = Clock::now();
+            if (now - lastSweep >= std::chrono::seconds(1)) {
+                lastSweep = now;
+                for (auto it = connections.begin(); it != connections.end();) {
+                    if (now - it->second.lastActivity > idleTimeout) {
+                        close(it->first);
+                        it = connections.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+        }
+        if (spare >= 0) close(spare);
+        close(epoll);
+    }
+
+    // Aceita as conexões na fila. Sem descritores livres (EMFILE/ENFILE), a
+    // conexão continuaria na fila e o epoll (por nível) acordaria sem parar:
+    // a reserva é liberada para aceitar e fechar a conexão na hora.
+    void acceptAll(int epoll, Socket listener, std::unordered_map<int, Connection>& connections, int& spare) {
+        while (true) {
+            int client = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (client < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                if ((errno != EMFILE && errno != ENFILE) || spare < 0) return; // EAGAIN: nada mais na fila
+                close(spare);
+                client = accept(listener, nullptr, nullptr);
+                if (client >= 0) close(client);
+                spare = open("/dev/null", O_RDONLY | O_CLOEXEC);
+                if (client < 0) return;
+                continue;
+            }
+
+            int on = 1;
+            setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = client;
+            epoll_ctl(epoll, EPOLL_CTL_ADD, client, &event);
+            connections.try_emplace(client, maxBodySize);
+        }
+    }
+
+    // Trata um evento da conexão: lê, responde o que estiver completo (em
+    // ordem) e envia. Retorna false quando a conexão deve ser fechada.
+    bool serve(int epoll, int fd, Connection& connection, unsigned events) {
+        connection.lastActivity = Clock::now();
+        if ((events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && !readFrom(fd, connection)) return false;
+
+        process(connection);
+        if (!writeTo(fd, connection)) return false;
+        // Respostas enviadas liberam espaço para as requisições já recebidas
+        if (connection.output.empty() && connection.parser.pending() > 0) {
+            process(connection);
+            if (!writeTo(fd, connection)) return false;
+        }
+
+        bool flushed = connection.output.empty();
+        if (flushed && (connection.closeAfterWrite || connection.peerClosed)) return false;
+        // Sem resposta a enviar, entrada cheia não vai andar: desiste
+        if (flushed && inputFull(connection)) return false;
+
+        unsigned interest = 0;
+        if (!connection.closeAfterWrite && !connection.peerClosed &&
+            connection.pendingOutput < MaxPendingOutput && !inputFull(connection)) {
+            interest |= EPOLLIN;
+        }
+        if (!flushed) interest |= EPOLLOUT;
+        if (interest != connection.interest) {
+            epoll_event event{};
+            event.events = interest;
+            event.data.fd = fd;
+            epoll_ctl(epoll, EPOLL_CTL_MOD, fd, &event);
+            connection.interest = interest;
+        }
+        return true;
+    }
+
+    // Entrada recebida e ainda não processada passou do que cabe numa
+    // requisição (cabeçalho + corpo): para de ler até processar
+    bool inputFull(const Connection& connection) const {
+        return connection.parser.pending() > HttpRequestParser::MaxHeaderSize + maxBodySize;
+    }
+
+    // Lê até MaxReadPerEvent bytes (epoll avisa de novo se sobrou algo);
+    // false em erro de socket
+    bool readFrom(int fd, Connection& connection) {
+        char buffer[16384];
+        std::size_t total = 0;
+        while (total < MaxReadPerEvent && !inputFull(connection)) {
+            ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+            if (received > 0) {
+                connection.parser.append(buffer, received);
+                total += received;
+                continue;
+            }
+            if (received == 0) {
+                connection.peerClosed = true; // Ainda responde o que já chegou
+                return true;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+            if (errno != EINTR) return false;
+        }
+        return true;
+    }
+
+    // Responde as requisições completas, até o limite de saída pendente
+    void process(Connection& connection) {
+        HttpRequest request;
+        while (!connection.closeAfterWrite && connection.pendingOutput < MaxPendingOutput) {
+            HttpRequestParser::Status status = connection.parser.next(request);
+            if (connection.parser.takeContinueRequest()) {
+                enqueue(connection, HttpResponse("HTTP/1.1 100 Continue\r\n\r\n"));
+            }
+            if (status == HttpRequestParser::Status::NeedMore) return;
+            if (status == HttpRequestParser::Status::Error) {
+                enqueue(connection, errorResponse(connection.parser.errorStatus()));
+                connection.closeAfterWrite = true;
+                return;
+            }
+
+            bool keepAlive = request.keepAlive() && !connection.peerClosed;
+            HttpResponse response = respond(request);
+            finalizeResponse(response, keepAlive);
+            enqueue(connection, std::move(response));
+            connection.closeAfterWrite = !keepAlive;
+        }
+    }
+
+    static void enqueue(Connection& connection, HttpResponse response) {
+        connection.pendingOutput += response.size();
+        connection.output.push_back(std::move(response));
+    }
+
+    // Envia o que o socket aceitar, várias respostas (cabeçalhos e corpo)
+    // por chamada; false em erro de socket
+    bool writeTo(int fd, Connection& connection) {
+        while (!connection.output.empty()) {
+            iovec parts[64];
+            int count = 0;
+            size_t skip = connection.sent;
+            for (const HttpResponse& response : connection.output) {
+                if (count + 2 > 64) break;
+                for (const std::string* part : {&response.text, response.body.get()}) {
+                    if (!part) continue;
+                    if (skip >= part->size()) {
+                        skip -= part->size();
+                        continue;
+                    }
+                    parts[count].iov_base = const_cast<char*>(part->data() + skip);
+                    parts[count].iov_len = part->size() - skip;
+                    count++;
+                    skip = 0;
+                }
+            }
+
+            msghdr message{};
+            message.msg_iov = parts;
+            message.msg_iovlen = count;
+            ssize_t n = sendmsg(fd, &message, MSG_NOSIGNAL);
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+
+            // Descarta as respostas enviadas por inteiro
+            connection.pendingOutput -= n;
+            connection.sent += n;
+            while (!connection.output.empty() && connection.sent >= connection.output.front().size()) {
+                connection.sent -= connection.output.front().size();
+                connection.output.pop_front();
+            }
+        }
+        return true;
+    }
+#endif
+
+    Handler handler;
+    std::vector<Socket> listenSockets;
+    std::chrono::milliseconds idleTimeout{15000};
+    std::size_t maxBodySize = MaxBodySize;
+};
+
+#endif
\ No newline at end of file
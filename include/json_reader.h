@@ -0,0 +1,311 @@
+#ifndef JSON_READER_H
+#define JSON_READER_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// Leitura de JSON sob demanda, numa passada e sem montar árvore: quem chama
+// pede o que espera (objeto, lista, texto...) e pula o resto com skip().
+// Chaves sem escapes são entregues como views do próprio texto. A varredura
+// de textos testa 8 bytes por vez (aspas, barra invertida ou controle).
+// Qualquer erro de sintaxe faz as leituras seguintes falharem (ok() falso).
+//   JsonReader json(body);
+//   std::string name;
+//   bool valid = json.forEachField([&](std::string_view key) {
+//       return key == "name" ? json.readString(name) : json.skip();
+//   }) && json.atEnd();
+class JsonReader {
+public:
+    enum class Type { Object, Array, String, Number, Bool, Null, Invalid };
+
+    static constexpr int MaxDepth = 64;
+
+    explicit JsonReader(std::string_view text) : text(text) {}
+
+    // Tipo do próximo valor, sem consumi-lo
+    Type peek() {
+        skipSpace();
+        if (failed || pos >= text.size()) return Type::Invalid;
+        switch (text[pos]) {
+        case '{': return Type::Object;
+        case '[': return Type::Array;
+        case '"': return Type::String;
+        case 't': case 'f': return Type::Bool;
+        case 'n': return Type::Null;
+        default:
+            return text[pos] == '-' || (text[pos] >= '0' && text[pos] <= '9') ? Type::Number : Type::Invalid;
+        }
+    }
+
+    // Objeto: field(chave) é chamado para cada campo e deve consumir o
+    // valor; retornar false interrompe com erro
+    template<typename Field>
+    bool forEachField(Field field) {
+        if (!enter('{')) return false;
+        if (consume('}')) return leave();
+        std::string scratch;
+        do {
+            std::string_view key;
+            if (peek() != Type::String || !readStringView(key, scratch) || !consume(':')) return fail();
+            if (!field(key) || failed) return fail();
+        } while (consume(','));
+        return consume('}') ? leave() : fail();
+    }
+
+    // Lista: item() é chamado para cada elemento e deve consumi-lo
+    template<typename Item>
+    bool forEachItem(Item item) {
+        if (!enter('[')) return false;
+        if (consume(']')) return leave();
+        do {
+            if (!item() || failed) return fail();
+        } while (consume(','));
+        return consume(']') ? leave() : fail();
+    }
+
+    bool readString(std::string& out) {
+        std::string_view view;
+        std::string scratch;
+        if (peek() != Type::String || !readStringView(view, scratch)) return fail();
+        out.assign(view.data(), view.size());
+        return true;
+    }
+
+    bool readBool(bool& out) {
+        skipSpace();
+        if (literal("true")) {
+            out = true;
+        } else if (literal("false")) {
+            out = false;
+        } else {
+            return fail();
+        }
+        return true;
+    }
+
+    bool readNumber(double& out) {
+        std::string_view number;
+        if (!scanNumber(number)) return fail();
+        out = std::strtod(std::string(number).c_str(), nullptr);
+        return true;
+    }
+
+    // Consome null; false (sem erro) se o próximo valor não for null
+    bool readNull() {
+        skipSpace();
+        return literal("null");
+    }
+
+    // Consome um valor qualquer, validando a sintaxe
+    bool skip() {
+        std::string_view ignored;
+        std::string scratch;
+        switch (peek()) {
+        case Type::Object: return forEachField([&](std::string_view) { return skip(); });
+        case Type::Array: return forEachItem([&] { return skip(); });
+        case Type::String: return readStringView(ignored, scratch) || fail();
+        case Type::Number: return scanNumber(ignored) || fail();
+        case Type::Bool: {
+            bool flag;
+            return readBool(flag);
+        }
+        case Type::Null: return readNull() || fail();
+        default: return fail();
+        }
+    }
+
+    // Só espaços depois do último valor
+    bool atEnd() {
+        skipSpace();
+        return !failed && pos == text.size();
+    }
+
+    bool ok() const {
+        return !failed;
+    }
+
+    std::size_t position() const {
+        return pos;
+    }
+
+private:
+    bool fail() {
+        failed = true;
+        return false;
+    }
+
+    void skipSpace() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\r' || text[pos] == '\t')) {
+            pos++;
+        }
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (failed || pos >= text.size() || text[pos] != c) return false;
+        pos++;
+        return true;
+    }
+
+    bool enter(char open) {
+        if (!consume(open) || ++depth > MaxDepth) return fail();
+        return true;
+    }
+
+    bool leave() {
+        depth--;
+        return true;
+    }
+
+    bool literal(std::string_view word) {
+        if (failed || text.compare(pos, word.size(), word) != 0) return false;
+        pos += word.size();
+        return true;
+    }
+
+    // Próximo '"', '\\' ou byte de controle a partir de i. Cada bloco de 8
+    // bytes é testado de uma vez (SWAR); só o bloco com ocorrência é
+    // percorrido byte a byte.
+    std::size_t scanString(std::size_t i) const {
+        const std::uint64_t ones = 0x0101010101010101ull, highs = 0x8080808080808080ull;
+        for (; i + 8 <= text.size(); i += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, text.data() + i, 8);
+            std::uint64_t quote = word ^ (ones * '"'), backslash = word ^ (ones * '\\');
+            std::uint64_t special = ((quote - ones) & ~quote) | ((backslash - ones) & ~backslash) |
+                                    ((word - ones * 0x20) & ~word);
+            if (special & highs) break;
+        }
+        while (i < text.size() && text[i] != '"' && text[i] != '\\' && (unsigned char)text[i] >= 0x20) i++;
+        return i;
+    }
+
+    // Texto em pos (na aspa inicial). Sem escapes, out aponta para o
+    // próprio texto; com escapes, é decodificado em scratch.
+    bool readStringView(std::string_view& out, std::string& scratch) {
+        std::size_t start = ++pos;
+        std::size_t end = scanString(start);
+        if (end < text.size() && text[end] == '"') {
+            out = text.substr(start, end - start);
+            pos = end + 1;
+            return true;
+        }
+
+        scratch.assign(text.data() + start, end - start);
+        pos = end;
+        while (pos < text.size()) {
+            char c = text[pos];
+            if (c == '"') {
+                pos++;
+                out = scratch;
+                return true;
+            }
+            if ((unsigned char)c < 0x20) return false;
+            if (c != '\\') {
+                std::size_t next = scanString(pos);
+                scratch.append(text.data() + pos, next - pos);
+                pos = next;
+                continue;
+            }
+            if (++pos >= text.size()) return false;
+            switch (text[pos++]) {
+            case '"': scratch += '"'; break;
+            case '\\': scratch += '\\'; break;
+            case '/': scratch += '/'; break;
+            case 'b': scratch += '\b'; break;
+            case 'f': scratch += '\f'; break;
+            case 'n': scratch += '\n'; break;
+            case 'r': scratch += '\r'; break;
+            case 't': scratch += '\t'; break;
+            case 'u': if (!readEscapedCodePoint(scratch)) return false; break;
+            default: return false;
+            }
+        }
+        return false;
+    }
+
+    // \uXXXX (já depois do "\u"), com pares substitutos, em UTF-8
+    bool readEscapedCodePoint(std::string& out) {
+        std::uint32_t code;
+        if (!readHex4(code)) return false;
+        if (code >= 0xD800 && code <= 0xDBFF) {
+            std::uint32_t low;
+            if (text.compare(pos, 2, "\\u") != 0) return false;
+            pos += 2;
+            if (!readHex4(low) || low < 0xDC00 || low > 0xDFFF) return false;
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        } else if (code >= 0xDC00 && code <= 0xDFFF) {
+            return false;
+        }
+
+        if (code < 0x80) {
+            out += (char)code;
+        } else if (code < 0x800) {
+            out += (char)(0xC0 | (code >> 6));
+            out += (char)(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += (char)(0xE0 | (code >> 12));
+            out += (char)(0x80 | ((code >> 6) & 0x3F));
+            out += (char)(0x80 | (code & 0x3F));
+        } else {
+            out += (char)(0xF0 | (code >> 18));
+            out += (char)(0x80 | ((code >> 12) & 0x3F));
+            out += (char)(0x80 | ((code >> 6) & 0x3F));
+            out += (char)(0x80 | (code & 0x3F));
+        }
+        return true;
+    }
+
+    bool readHex4(std::uint32_t& code) {
+        if (pos + 4 > text.size()) return false;
+        code = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = text[pos++];
+            int digit = c >= '0' && c <= '9' ? c - '0' :
+                        c >= 'a' && c <= 'f' ? c - 'a' + 10 :
+                        c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+            if (digit < 0) return false;
+            code = code * 16 + digit;
+        }
+        return true;
+    }
+
+    // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+    bool scanNumber(std::string_view& out) {
+        skipSpace();
+        if (failed) return false;
+        std::size_t start = pos;
+        auto digits = [&] {
+            std::size_t first = pos;
+            while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') pos++;
+            return pos - first;
+        };
+        if (pos < text.size() && text[pos] == '-') pos++;
+        if (pos < text.size() && text[pos] == '0') {
+            pos++;
+        } else if (digits() == 0) {
+            return false;
+        }
+        if (pos < text.size() && text[pos] == '.') {
+            pos++;
+            if (digits() == 0) return false;
+        }
+        if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+            pos++;
+            if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) pos++;
+            if (digits() == 0) return false;
+        }
+        out = text.substr(start, pos - start);
+        return true;
+    }
+
+    std::string_view text;
+    std::size_t pos = 0;
+    int depth = 0;
+    bool failed = false;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,132 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <charconv>
+#include <string>
+#include <string_view>
+
+// Escreve JSON direto no fim de um buffer, sem strings temporárias: os
+// textos são escapados no próprio buffer, em blocos entre os caracteres
+// especiais. As vírgulas entre itens são postas sozinhas.
+//   JsonWriter json(buffer);
+//   json.beginObject().key("count").value(3).endObject();
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) : out(out) {}
+
+    JsonWriter& beginObject() {
+        separate();
+        out += '{';
+        needsComma = false;
+        return *this;
+    }
+
+    JsonWriter& endObject() {
+        out += '}';
+        needsComma = true;
+        return *this;
+    }
+
+    JsonWriter& beginArray() {
+        separate();
+        out += '[';
+        needsComma = false;
+        return *this;
+    }
+
+    JsonWriter& endArray() {
+        out += ']';
+        needsComma = true;
+        return *this;
+    }
+
+    JsonWriter& key(std::string_view name) {
+        separate();
+        writeString(name);
+        out += ':';
+        needsComma = false;
+        return *this;
+    }
+
+    JsonWriter& value(std::string_view text) {
+        separate();
+        writeString(text);
+        needsComma = true;
+        return *this;
+    }
+
+    // Sem esta sobrecarga, value("...") escolheria value(bool)
+    JsonWriter& value(const char* text) {
+        return value(std::string_view(text));
+    }
+
+    JsonWriter& value(bool flag) {
+        separate();
+        out += flag ? "true" : "false";
+        needsComma = true;
+        return *this;
+    }
+
+    JsonWriter& value(long long number) {
+        separate();
+        char digits[24];
+        auto end = std::to_chars(digits, digits + sizeof(digits), number).ptr;
+        out.append(digits, end - digits);
+        needsComma = true;
+        return *this;
+    }
+
+    JsonWriter& value(int number) {
+        return value((long long)number);
+    }
+
+    JsonWriter& null() {
+        separate();
+        out += "null";
+        needsComma = true;
+        return *this;
+    }
+
+    // Texto entre aspas, com ", \ e caracteres de controle escapados
+    static void escape(std::string& out, std::string_view text) {
+        static const char hex[] = "0123456789abcdef";
+        std::size_t start = 0;
+        for (std::size_t i = 0; i < text.size(); i++) {
+            unsigned char c = (unsigned char)text[i];
+            if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+            out.append(text.data() + start, i - start);
+            start = i + 1;
+            switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 15];
+            }
+        }
+        out.append(text.data() + start, text.size() - start);
+    }
+
+private:
+    void separate() {
+        if (needsComma) out += ',';
+    }
+
+    void writeString(std::string_view text) {
+        out += '"';
+        escape(out, text);
+        out += '"';
+    }
+
+    std::string& out;
+    bool needsComma = false;
+};
+
+#endif
\ No newline at end of file
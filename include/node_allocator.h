@@ -0,0 +1,117 @@
+#ifndef NODE_ALLOCATOR_H
+#define NODE_ALLOCATOR_H
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+
+// Alocador padrão: um new/delete por nó, como antes.
+template<typename Node>
+class HeapNodeAllocator {
+public:
+    // Cada nó tem sua própria alocação, então não há liberação em bloco
+    static constexpr bool releasesInBulk = false;
+
+    template<typename... Args>
+    Node* create(Args&&... args) {
+        return new Node(std::forward<Args>(args)...);
+    }
+
+    void destroy(Node* node) {
+        delete node;
+    }
+
+    void releaseAll() {}
+};
+
+// Pool de nós em blocos (slabs) contíguos. Nós removidos voltam para uma
+// lista livre e são reaproveitados; os blocos só são devolvidos ao sistema
+// em releaseAll(), com custo proporcional ao número de blocos.
+template<typename Node>
+class PoolNodeAllocator {
+private:
+    union Slot {
+        Slot* next;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    static constexpr std::size_t FirstSlabSize = 64;
+    static constexpr std::size_t MaxSlabSize = 65536;
+
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+    Slot* freeList = nullptr;
+    std::size_t used = 0;     // Slots já entregues no bloco atual
+    std::size_t capacity = 0; // Tamanho do bloco atual
+
+    Slot* acquire() {
+        if (freeList) {
+            Slot* slot = freeList;
+            freeList = slot->next;
+            return slot;
+        }
+        if (used == capacity) {
+            // Blocos crescem geometricamente até MaxSlabSize
+            capacity = capacity ? std::min(capacity * 2, MaxSlabSize) : FirstSlabSize;
+            slabs.emplace_back(new Slot[capacity]);
+            used = 0;
+        }
+        return &slabs.back()[used++];
+    }
+
+public:
+    static constexpr bool releasesInBulk = true;
+
+    PoolNodeAllocator() = default;
+    PoolNodeAllocator(const PoolNodeAllocator&) = delete;
+    PoolNodeAllocator& operator=(const PoolNodeAllocator&) = delete;
+
+    PoolNodeAllocator(PoolNodeAllocator&& other) noexcept
+        : slabs(std::move(other.slabs)), freeList(other.freeList),
+          used(other.used), capacity(other.capacity) {
+        other.freeList = nullptr;
+        other.used = other.capacity = 0;
+    }
+
+    PoolNodeAllocator& operator=(PoolNodeAllocator&& other) noexcept {
+        if (this != &other) {
+            slabs = std::move(other.slabs);
+            freeList = other.freeList;
+            used = other.used;
+            capacity = other.capacity;
+            other.slabs.clear();
+            other.freeList = nullptr;
+            other.used = other.capacity = 0;
+        }
+        return *this;
+    }
+
+    template<typename... Args>
+    Node* create(Args&&... args) {
+        Slot* slot = acquire();
+        return new (slot->storage) Node(std::forward<Args>(args)...);
+    }
+
+    void destroy(Node* node) {
+        node->~Node();
+        Slot* slot = reinterpret_cast<Slot*>(node);
+        slot->next = freeList;
+        freeList = slot;
+    }
+
+    // Devolve todos os blocos. Os nós ainda vivos precisam ter sido
+    // destruídos antes, a menos que não tenham destrutor.
+    void releaseAll() {
+        slabs.clear();
+        freeList = nullptr;
+        used = capacity = 0;
+    }
+
+    std::size_t slabCount() const {
+        return slabs.size();
+    }
+};
+
+#endif
\ No newline at end of file
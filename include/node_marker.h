@@ -0,0 +1,35 @@
+#ifndef NODE_MARKER_H
+#define NODE_MARKER_H
+
+#include "contact.h"
+
+// Marcadores: predicados cuja contagem cada nó guarda para a sua subárvore
+// (árvore aumentada). Com eles a árvore conta os elementos marcados em O(1),
+// enumera só esses pulando subárvores sem nenhum e faz rank/select entre
+// eles. Um marcador só pode depender de campos que não mudam enquanto o
+// elemento está na árvore, a não ser via remoção e reinserção.
+
+// Nenhum elemento marcado
+struct NoMarker {
+    template<typename T>
+    static bool marked(const T&) {
+        return false;
+    }
+};
+
+// Elementos com isFavorite() verdadeiro
+struct FavoriteMarker {
+    template<typename T>
+    static bool marked(const T& value) {
+        return value.isFavorite();
+    }
+};
+
+// Marcador usado quando a árvore não especifica um
+template<typename T>
+struct DefaultMarker : NoMarker {};
+
+template<>
+struct DefaultMarker<Contact> : FavoriteMarker {};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,448 @@
+#ifndef PERSISTENT_AVL_TREE_H
+#define PERSISTENT_AVL_TREE_H
+
+#include "node_marker.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+
+// AVL persistente (imutável). Cada escrita copia apenas o caminho da raiz
+// até o ponto alterado e compartilha o resto com a versão anterior. A raiz
+// atual é publicada atomicamente: leitores pegam um Snapshot sem bloqueio
+// e o enxergam inteiro e consistente enquanto quiserem, mesmo com escritas
+// acontecendo em paralelo. Compare e Marker funcionam como em AVLTree.
+template<typename T, typename Compare = std::less<T>, typename Marker = DefaultMarker<T>>
+class PersistentAVLTree {
+private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    struct Node {
+        T data;
+        NodePtr left;
+        NodePtr right;
+        int height;
+        int count;  // Quantidade de nós na subárvore
+        int marked; // Quantos desses satisfazem Marker
+
+        Node(T value, NodePtr l, NodePtr r)
+            : data(std::move(value)), left(std::move(l)), right(std::move(r)),
+              height(std::max(heightOf(left), heightOf(right)) + 1),
+              count(countOf(left) + countOf(right) + 1),
+              marked(markedOf(left) + markedOf(right) + isMarked(data)) {}
+    };
+
+    NodePtr root;          // Lido e publicado apenas com atomic_load/atomic_store
+    std::mutex writeMutex; // Serializa os escritores
+
+    static bool lessThan(const T& a, const T& b) {
+        return Compare()(a, b);
+    }
+
+    static int heightOf(const NodePtr& node) {
+        return node ? node->height : 0;
+    }
+
+    static int countOf(const NodePtr& node) {
+        return node ? node->count : 0;
+    }
+
+    static int markedOf(const NodePtr& node) {
+        return node ? node->marked : 0;
+    }
+
+    static int isMarked(const T& value) {
+        return Marker::marked(value) ? 1 : 0;
+    }
+
+    static NodePtr makeNode(T data, NodePtr left, NodePtr right) {
+        return std::make_shared<const Node>(std::move(data), std::move(left), std::move(right));
+    }
+
+    // Monta um nó novo com os filhos dados, aplicando as rotações
+    // LL, RR, LR e RL sobre cópias quando a diferença de altura passa de 1
+    static NodePtr balance(const T& data, NodePtr left, NodePtr right) {
+        int hl = heightOf(left);
+        int hr = heightOf(right);
+
+        if (hl > hr + 1) {
+            if (heightOf(left->left) >= heightOf(left->right)) {
+                return makeNode(left->data, left->left,
+                                makeNode(data, left->right, std::move(right)));
+            }
+            const NodePtr& lr = left->right;
+            return makeNode(lr->data,
+                            makeNode(left->data, left->left, lr->left),
+                            makeNode(data, lr->right, std::move(right)));
+        }
+
+        if (hr > hl + 1) {
+            if (heightOf(right->right) >= heightOf(right->left)) {
+                return makeNode(right->data,
+                                makeNode(data, std::move(left), right->left),
+                                right->right);
+            }
+            const NodePtr& rl = right->left;
+            return makeNode(rl->data,
+                            makeNode(data, std::move(left), rl->left),
+                            makeNode(right->data, rl->right, right->right));
+        }
+
+        return makeNode(data, std::move(left), std::move(right));
+    }
+
+    // Inserção com cópia de caminho. Se o valor já existe, devolve o próprio
+    // nó e nada é copiado.
+    static NodePtr insertRec(const NodePtr& node, const T& value, bool& changed) {
+        if (!node) {
+            changed = true;
+            return makeNode(value, nullptr, nullptr);
+        }
+
+        if (lessThan(value, node->data)) {
+            NodePtr left = insertRec(node->left, value, changed);
+            return changed ? balance(node->data, std::move(left), node->right) : node;
+        }
+        if (lessThan(node->data, value)) {
+            NodePtr right = insertRec(node->right, value, changed);
+            return changed ? balance(node->data, node->left, std::move(right)) : node;
+        }
+        return node; // Duplicado
+    }
+
+    // Remove o menor elemento; min aponta para o dado no nó original
+    static NodePtr removeMin(const NodePtr& node, const T*& min) {
+        if (!node->left) {
+            min = &node->data;
+            return node->right;
+        }
+        return balance(node->data, removeMin(node->left, min), node->right);
+    }
+
+    static NodePtr removeRec(const NodePtr& node, const T& value, bool& changed) {
+        if (!node) return nullptr;
+
+        if (lessThan(value, node->data)) {
+            NodePtr left = removeRec(node->left, value, changed);
+            return changed ? balance(node->data, std::move(left), node->right) : node;
+        }
+        if (lessThan(node->data, value)) {
+            NodePtr right = removeRec(node->right, value, changed);
+            return changed ? balance(node->data, node->left, std::move(right)) : node;
+        }
+
+        changed = true;
+        if (!node->left) return node->right;
+        if (!node->right) return node->left;
+
+        const T* min = nullptr;
+        NodePtr right = removeMin(node->right, min);
+        return balance(*min, node->left, std::move(right));
+    }
+
+    // Troca o elemento equivalente a value, copiando só o caminho até ele.
+    // A forma da árvore não muda, então não há rebalanceamento.
+    static NodePtr replaceRec(const NodePtr& node, const T& value, bool& changed) {
+        if (!node) return nullptr;
+
+        if (lessThan(value, node->data)) {
+            NodePtr left = replaceRec(node->left, value, changed);
+            return changed ? makeNode(node->data, std::move(left), node->right) : node;
+        }
+        if (lessThan(node->data, value)) {
+            NodePtr right = replaceRec(node->right, value, changed);
+            return changed ? makeNode(node->data, node->left, std::move(right)) : node;
+        }
+        changed = true;
+        return makeNode(value, node->left, node->right);
+    }
+
+    // n elementos tirados de next() em ordem: metade à esquerda, um na
+    // raiz e o resto à direita, então as alturas diferem de no máximo 1
+    template<typename Next>
+    static NodePtr buildRec(int n, Next& next) {
+        if (n == 0) return nullptr;
+        NodePtr left = buildRec(n / 2, next);
+        T value = next();
+        NodePtr right = buildRec(n - n / 2 - 1, next);
+        return makeNode(std::move(value), std::move(left), std::move(right));
+    }
+
+    template<typename Visitor>
+    static void forEachRec(const Node* node, Visitor& visit) {
+        if (!node) return;
+
+        forEachRec(node->left.get(), visit);
+        visit(node->data);
+        forEachRec(node->right.get(), visit);
+    }
+
+    // Visita só os marcados, pulando subárvores sem nenhum
+    template<typename Visitor>
+    static void forEachMarkedRec(const Node* node, Visitor& visit) {
+        if (!node || node->marked == 0) return;
+
+        forEachMarkedRec(node->left.get(), visit);
+        if (isMarked(node->data)) visit(node->data);
+        forEachMarkedRec(node->right.get(), visit);
+    }
+
+    // Visita em ordem a partir do primeiro elemento em que skip é falso
+    // (skip monótono na ordem da árvore). Para quando visit retorna false.
+    template<typename Predicate, typename Visitor>
+    static bool visitFromRec(const Node* node, Predicate& skip, Visitor& visit) {
+        if (!node) return true;
+
+        if (skip(node->data)) {
+            return visitFromRec(node->right.get(), skip, visit);
+        }
+        return visitFromRec(node->left.get(), skip, visit) &&
+               visit(node->data) &&
+               visitFromRec(node->right.get(), skip, visit);
+    }
+
+    // Como visitFromRec, mas o início é a posição k na ordem
+    template<typename Visitor>
+    static bool visitFromRankRec(const Node* node, int k, Visitor& visit) {
+        if (!node) return true;
+
+        int leftCount = countOf(node->left);
+        if (k > leftCount) {
+            return visitFromRankRec(node->right.get(), k - leftCount - 1, visit);
+        }
+        return visitFromRankRec(node->left.get(), k, visit) &&
+               visit(node->data) &&
+               visitFromRankRec(node->right.get(), 0, visit);
+    }
+
+    static bool isBalancedRec(const Node* node) {
+        if (!node) return true;
+
+        int bf = heightOf(node->left) - heightOf(node->right);
+        return std::abs(bf) <= 1 &&
+               node->height == std::max(heightOf(node->left), heightOf(node->right)) + 1 &&
+               node->count == countOf(node->left) + countOf(node->right) + 1 &&
+               node->marked == markedOf(node->left) + markedOf(node->right) + isMarked(node->data) &&
+               isBalancedRec(node->left.get()) &&
+               isBalancedRec(node->right.get());
+    }
+
+public:
+    // Versão imutável da árvore. Copiar um Snapshot é O(1); inserted() e
+    // removed() devolvem novas versões sem alterar esta.
+    class Snapshot {
+    public:
+        Snapshot() = default;
+
+        int size() const {
+            return countOf(root);
+        }
+
+        bool isEmpty() const {
+            return root == nullptr;
+        }
+
+        // O ponteiro vale enquanto este Snapshot (ou uma cópia) existir
+        const T* search(const T& value) const {
+            const Node* node = root.get();
+            while (node) {
+                if (lessThan(value, node->data)) {
+                    node = node->left.get();
+                } else if (lessThan(node->data, value)) {
+                    node = node->right.get();
+                } else {
+                    return &node->data;
+                }
+            }
+            return nullptr;
+        }
+
+        bool contains(const T& value) const {
+            return search(value) != nullptr;
+        }
+
+        template<typename Visitor>
+        void forEach(Visitor visit) const {
+            forEachRec(root.get(), visit);
+        }
+
+        bool isBalanced() const {
+            return isBalancedRec(root.get());
+        }
+
+        // Elementos marcados: contagem em O(1), visita em O(m log n)
+        int markedCount() const {
+            return markedOf(root);
+        }
+
+        template<typename Visitor>
+        void forEachMarked(Visitor visit) const {
+            forEachMarkedRec(root.get(), visit);
+        }
+
+        // Consultas por intervalo, O(log n + k)
+
+        template<typename Predicate, typename Visitor>
+        void visitFrom(Predicate skip, Visitor visit) const {
+            visitFromRec(root.get(), skip, visit);
+        }
+
+        // Visita em ordem os elementos maiores que o valor (paginação por
+        // cursor), até visit retornar false
+        template<typename Visitor>
+        void visitAfter(const T& value, Visitor visit) const {
+            visitFrom([&](const T& x) { return !lessThan(value, x); }, visit);
+        }
+
+        // Visita em ordem a partir do k-ésimo elemento (a partir de 0), até
+        // visit retornar false; O(log n) para achar o início pelas contagens
+        template<typename Visitor>
+        void visitFromRank(int k, Visitor visit) const {
+            visitFromRankRec(root.get(), k, visit);
+        }
+
+        // Quantos elementos são menores que o valor (a posição dele na
+        // ordem, se estiver presente); O(log n) pelas contagens
+        int rank(const T& value) const {
+            int rank = 0;
+            for (const Node* node = root.get(); node;) {
+                if (lessThan(node->data, value)) {
+                    rank += countOf(node->left) + 1;
+                    node = node->right.get();
+                } else {
+                    node = node->left.get();
+                }
+            }
+            return rank;
+        }
+
+        // Primeiro elemento que não é menor que o valor
+        const T* lowerBound(const T& value) const {
+            return partitionPoint([&](const T& x) { return lessThan(x, value); });
+        }
+
+        // Primeiro elemento maior que o valor
+        const T* upperBound(const T& value) const {
+            return partitionPoint([&](const T& x) { return !lessThan(value, x); });
+        }
+
+        // Visita os elementos em [from, to), parando após limit visitas
+        // (limit < 0: sem limite). Retorna quantos foram visitados.
+        template<typename Visitor>
+        int range(const T& from, const T& to, Visitor visit, int limit = -1) const {
+            int visited = 0;
+            visitFrom([&](const T& x) { return lessThan(x, from); },
+                      [&](const T& x) {
+                          if (visited == limit || !lessThan(x, to)) return false;
+                          visit(x);
+                          visited++;
+                          return true;
+                      });
+            return visited;
+        }
+
+        Snapshot inserted(const T& value) const {
+            bool changed = false;
+            return Snapshot(insertRec(root, value, changed));
+        }
+
+        Snapshot removed(const T& value) const {
+            bool changed = false;
+            return Snapshot(removeRec(root, value, changed));
+        }
+
+        // Substitui o elemento de mesma chave sem rebalancear; se não
+        // existe, devolve a mesma versão
+        Snapshot replaced(const T& value) const {
+            bool changed = false;
+            return Snapshot(replaceRec(root, value, changed));
+        }
+
+        // Versão com os n elementos dados por next(), que devem vir em
+        // ordem e sem repetidos; montada de baixo para cima em O(n), sem
+        // rotações
+        template<typename Next>
+        static Snapshot fromSorted(int n, Next next) {
+            return Snapshot(buildRec(n, next));
+        }
+
+        // Mesma versão (nenhuma cópia foi necessária)
+        bool sameVersion(const Snapshot& other) const {
+            return root == other.root;
+        }
+
+    private:
+        friend class PersistentAVLTree;
+
+        // Primeiro elemento em que skip é falso
+        template<typename Predicate>
+        const T* partitionPoint(Predicate skip) const {
+            const T* found = nullptr;
+            visitFrom(skip, [&](const T& x) { found = &x; return false; });
+            return found;
+        }
+
+        explicit Snapshot(NodePtr r) : root(std::move(r)) {}
+
+        NodePtr root;
+    };
+
+    PersistentAVLTree() = default;
+    PersistentAVLTree(const PersistentAVLTree&) = delete;
+    PersistentAVLTree& operator=(const PersistentAVLTree&) = delete;
+
+    // Leitura sem bloqueio da versão atual
+    Snapshot snapshot() const {
+        return Snapshot(std::atomic_load(&root));
+    }
+
+    // Escritas são serializadas entre si, mas nunca esperam por leitores
+    bool insert(const T& value) {
+        return modify([&](Snapshot& version) {
+            Snapshot next = version.inserted(value);
+            bool changed = !next.sameVersion(version);
+            version = next;
+            return changed;
+        });
+    }
+
+    bool remove(const T& value) {
+        return modify([&](Snapshot& version) {
+            Snapshot next = version.removed(value);
+            bool changed = !next.sameVersion(version);
+            version = next;
+            return changed;
+        });
+    }
+
+    // Operação composta: f recebe uma cópia da versão atual, pode trocá-la
+    // por versões derivadas e retorna se algo mudou. A versão final é
+    // publicada de uma vez, então leitores nunca veem estados intermediários.
+    template<typename F>
+    bool modify(F f) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        Snapshot version = snapshot();
+        bool changed = f(version);
+        if (changed) {
+            std::atomic_store(&root, version.root);
+        }
+        return changed;
+    }
+
+    int size() const {
+        return snapshot().size();
+    }
+
+    bool isEmpty() const {
+        return snapshot().isEmpty();
+    }
+
+    bool contains(const T& value) const {
+        return snapshot().contains(value);
+    }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,213 @@
+#ifndef STATIC_ASSETS_H
+#define STATIC_ASSETS_H
+
+#include "gzip.h"
+#include "http_parser.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+// Compile com -DAGENDA_BROTLI (e -lbrotlienc) para servir também brotli
+#ifdef AGENDA_BROTLI
+#include <brotli/encode.h>
+#endif
+
+// Arquivos estáticos (web/) em memória. Cada arquivo é lido uma vez,
+// ganha uma ETag (hash do conteúdo) e versões comprimidas (gzip e, com
+// AGENDA_BROTLI, brotli) feitas na carga; a resposta escolhe a versão pelo
+// Accept-Encoding e responde 304 quando If-None-Match traz a ETag atual.
+// Os corpos são compartilhados (HttpResponse::body), sem cópia por
+// requisição. A data de modificação é conferida no máximo uma vez por
+// checkInterval, e o arquivo é recarregado se tiver mudado.
+class StaticAssets {
+public:
+    explicit StaticAssets(std::chrono::milliseconds checkInterval = std::chrono::seconds(1))
+        : checkInterval(checkInterval) {}
+
+    // Carrega agora, em vez de na primeira requisição
+    void preload(const std::string& filename) {
+        std::lock_guard<std::mutex> lock(mutex);
+        current(filename);
+    }
+
+    HttpResponse serve(const std::string& filename, const HttpRequest& request) {
+        std::shared_ptr<const Asset> asset;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            asset = current(filename);
+        }
+        if (!asset) {
+            return "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\n\r\nArquivo nao encontrado: " + filename;
+        }
+
+        const Variant* variant = &asset->identity;
+        const std::string* accepted = request.header("accept-encoding");
+        if (accepted) {
+            for (const Variant* candidate : {&asset->brotli, &asset->gzip}) {
+                if (candidate->body && acceptQuality(*accepted, candidate->encoding) > 0) {
+                    variant = candidate;
+                    break;
+                }
+            }
+        }
+
+        std::string headers = "Content-Type: " + asset->contentType + "\r\nETag: " + variant->etag +
+                              "\r\nCache-Control: no-cache\r\nVary: Accept-Encoding\r\n";
+        const std::string* tags = request.header("if-none-match");
+        if (tags && matchesTag(*tags, variant->etag)) {
+            return "HTTP/1.1 304 Not Modified\r\n" + headers + "\r\n";
+        }
+        if (!variant->encoding.empty()) headers += "Content-Encoding: " + variant->encoding + "\r\n";
+        return HttpResponse("HTTP/1.1 200 OK\r\n" + headers + "\r\n", variant->body);
+    }
+
+    static std::string contentTypeOf(std::string_view filename) {
+        auto endsWith = [&](std::string_view suffix) {
+            return filename.size() >= suffix.size() &&
+                   filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) == 0;
+        };
+        if (endsWith(".html")) return "text/html; charset=utf-8";
+        if (endsWith(".css")) return "text/css";
+        if (endsWith(".js")) return "application/javascript";
+        if (endsWith(".json")) return "application/json";
+        return "text/plain";
+    }
+
+    // Peso q de coding em Accept-Encoding; 0 se recusado ou não citado
+    // ("*" vale para os não citados)
+    static double acceptQuality(std::string_view header, std::string_view coding) {
+        double star = 0;
+        while (!header.empty()) {
+            std::size_t end = header.find(',');
+            std::string_view item = trim(header.substr(0, end));
+            std::size_t semicolon = item.find(';');
+            std::string_view name = trim(item.substr(0, semicolon));
+            double quality = 1;
+            if (semicolon != std::string_view::npos) {
+                std::string_view params = item.substr(semicolon + 1);
+                std::size_t q = params.find("q=");
+                if (q != std::string_view::npos) quality = std::atof(std::string(params.substr(q + 2)).c_str());
+            }
+            if (HttpRequest::equalsIgnoreCase(name, coding)) return quality;
+            if (name == "*") star = quality;
+            if (end == std::string_view::npos) break;
+            header.remove_prefix(end + 1);
+        }
+        return star;
+    }
+
+private:
+    struct Variant {
+        std::string encoding; // Vazio: sem compressão
+        std::string etag;
+        std::shared_ptr<const std::string> body;
+    };
+
+    struct Asset {
+        std::string contentType;
+        Variant identity, gzip, brotli;
+    };
+
+    struct Entry {
+        std::shared_ptr<const Asset> asset;
+        std::filesystem::file_time_type modified;
+        std::chrono::steady_clock::time_point checked;
+    };
+
+    // Versão atual do arquivo, recarregada se mudou; chamada com mutex
+    std::shared_ptr<const Asset> current(const std::string& filename) {
+        auto now = std::chrono::steady_clock::now();
+        auto found = entries.find(filename);
+        if (found != entries.end() && now - found->second.checked < checkInterval) {
+            return found->second.asset;
+        }
+
+        Entry& entry = entries[filename];
+        entry.checked = now;
+        std::error_code error;
+        auto modified = std::filesystem::last_write_time(filename, error);
+        if (error) {
+            entry.asset = nullptr;
+        } else if (!entry.asset || modified != entry.modified) {
+            entry.asset = load(filename);
+            entry.modified = modified;
+        }
+        return entry.asset;
+    }
+
+    static std::shared_ptr<const Asset> load(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) return nullptr;
+        std::ostringstream content;
+        content << file.rdbuf();
+
+        auto asset = std::make_shared<Asset>();
+        asset->contentType = contentTypeOf(filename);
+        std::string text = content.str();
+        std::string tag = fingerprint(text);
+        asset->identity = {"", "\"" + tag + "\"", std::make_shared<const std::string>(std::move(text))};
+
+        // Versões comprimidas só quando ficam menores
+        const std::string& original = *asset->identity.body;
+        std::string gzip = Gzip::compress(original);
+        if (gzip.size() < original.size()) {
+            asset->gzip = {"gzip", "\"" + tag + "-gzip\"", std::make_shared<const std::string>(std::move(gzip))};
+        }
+#ifdef AGENDA_BROTLI
+        std::string brotli(BrotliEncoderMaxCompressedSize(original.size()), '\0');
+        std::size_t size = brotli.size();
+        if (BrotliEncoderCompress(BROTLI_MAX_QUALITY, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT, original.size(),
+                                  (const std::uint8_t*)original.data(), &size, (std::uint8_t*)&brotli[0]) &&
+            size < original.size()) {
+            brotli.resize(size);
+            asset->brotli = {"br", "\"" + tag + "-br\"", std::make_shared<const std::string>(std::move(brotli))};
+        }
+#endif
+        return asset;
+    }
+
+    // FNV-1a de 64 bits do conteúdo, em hexadecimal
+    static std::string fingerprint(std::string_view content) {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : content) {
+            hash = (hash ^ c) * 1099511628211ull;
+        }
+        static const char digits[] = "0123456789abcdef";
+        std::string tag(16, '0');
+        for (int i = 15; i >= 0; i--, hash >>= 4) tag[i] = digits[hash & 15];
+        return tag;
+    }
+
+    // If-None-Match: "*" ou lista de ETags (W/ é ignorado: comparação fraca)
+    static bool matchesTag(std::string_view tags, std::string_view etag) {
+        while (!tags.empty()) {
+            std::size_t end = tags.find(',');
+            std::string_view tag = trim(tags.substr(0, end));
+            if (tag.compare(0, 2, "W/") == 0) tag.remove_prefix(2);
+            if (tag == "*" || tag == etag) return true;
+            if (end == std::string_view::npos) break;
+            tags.remove_prefix(end + 1);
+        }
+        return false;
+    }
+
+    static std::string_view trim(std::string_view text) {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+        return text;
+    }
+
+    std::chrono::milliseconds checkInterval;
+    std::mutex mutex;
+    std::map<std::string, Entry> entries;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef UPDATE_VIEW_H
+#define UPDATE_VIEW_H
+
+#include "contact.h"
+#include <string_view>
+
+// Visões usadas por update(): o mutador recebe apenas os campos que não
+// fazem parte da chave, então uma alteração que mudaria a ordem do
+// elemento na árvore nem compila. Tipos sem UpdateView não têm update().
+template<typename T>
+struct UpdateView;
+
+// Campos de um contato que podem mudar sem tirá-lo do lugar na agenda
+class ContactDetails {
+public:
+    explicit ContactDetails(Contact& contact) : contact(contact) {}
+
+    ContactDetails(const ContactDetails&) = delete;
+    ContactDetails& operator=(const ContactDetails&) = delete;
+
+    std::string_view getName() const { return contact.getName(); }
+    std::string_view getPhone() const { return contact.getPhone(); }
+    std::string_view getEmail() const { return contact.getEmail(); }
+    bool isFavorite() const { return contact.isFavorite(); }
+
+    void setPhone(std::string_view phone) { contact.setPhone(phone); }
+    void setEmail(std::string_view email) { contact.setEmail(email); }
+    void setFavorite(bool favorite) { contact.setFavorite(favorite); }
+
+private:
+    Contact& contact;
+};
+
+template<>
+struct UpdateView<Contact> {
+    using type = ContactDetails;
+};
+
+#endif
\ No newline at end of file
@@ -1,32 +1,119 @@
 #include "contact.h"
+#include <cstring>
+#include <stdexcept>
 
-Contact::Contact(const std::string& name, const std::string& phone, 
-                 const std::string& email, bool favorite)
-    : name(name), phone(phone), email(email), favorite(favorite) {}
+Contact::Contact(std::string_view name, std::string_view phone, 
+                 std::string_view email, bool favorite)
+    : nameLength(0), phoneLength(0), emailLength(0), favorite(favorite) {
+    assign(name, phone, email);
+}
+
+Contact::Contact(const Contact& other)
+    : nameLength(0), phoneLength(0), emailLength(0), favorite(other.favorite) {
+    assign(other.getName(), other.getPhone(), other.getEmail());
+}
+
+Contact::Contact(Contact&& other) noexcept
+    : nameLength(other.nameLength), phoneLength(other.phoneLength),
+      emailLength(other.emailLength), favorite(other.favorite) {
+    // O buffer (interno ou não) é copiado como bytes; o de fora muda de dono
+    std::memcpy(inlineData, other.inlineData, InlineCapacity);
+    other.nameLength = other.phoneLength = other.emailLength = 0;
+}
+
+Contact& Contact::operator=(const Contact& other) {
+    if (this != &other) {
+        assign(other.getName(), other.getPhone(), other.getEmail());
+        favorite = other.favorite;
+    }
+    return *this;
+}
+
+Contact& Contact::operator=(Contact&& other) noexcept {
+    if (this != &other) {
+        release();
+        std::memcpy(inlineData, other.inlineData, InlineCapacity);
+        nameLength = other.nameLength;
+        phoneLength = other.phoneLength;
+        emailLength = other.emailLength;
+        favorite = other.favorite;
+        other.nameLength = other.phoneLength = other.emailLength = 0;
+    }
+    return *this;
+}
+
+Contact::~Contact() {
+    release();
+}
+
+// Monta o buffer novo antes de liberar o atual, pois os campos recebidos
+// podem ser views do próprio contato
+void Contact::assign(std::string_view name, std::string_view phone, std::string_view email) {
+    if (name.size() > MaxFieldLength || phone.size() > MaxFieldLength ||
+        email.size() > MaxFieldLength) {
+        throw std::length_error("Campo de contato muito longo");
+    }
+    
+    std::size_t total = name.size() + phone.size() + email.size();
+    char local[InlineCapacity];
+    char* buffer = total > InlineCapacity ? new char[total] : local;
+    std::memcpy(buffer, name.data(), name.size());
+    std::memcpy(buffer + name.size(), phone.data(), phone.size());
+    std::memcpy(buffer + name.size() + phone.size(), email.data(), email.size());
+    
+    release();
+    if (total > InlineCapacity) {
+        heapData = buffer;
+    } else {
+        std::memcpy(inlineData, local, total);
+    }
+    nameLength = (std::uint16_t)name.size();
+    phoneLength = (std::uint16_t)phone.size();
+    emailLength = (std::uint16_t)email.size();
+}
+
+void Contact::release() {
+    if (totalLength() > InlineCapacity) {
+        delete[] heapData;
+    }
+    nameLength = phoneLength = emailLength = 0;
+}
+
+std::size_t Contact::totalLength() const {
+    return (std::size_t)nameLength + phoneLength + emailLength;
+}
+
+const char* Contact::data() const {
+    return totalLength() > InlineCapacity ? heapData : inlineData;
+}
+
+std::size_t Contact::heapBytes() const {
+    return totalLength() > InlineCapacity ? totalLength() : 0;
+}
 
-std::string Contact::getName() const { return name; }
-std::string Contact::getPhone() const { return phone; }
-std::string Contact::getEmail() const { return email; }
+std::string_view Contact::getName() const { return std::string_view(data(), nameLength); }
+std::string_view Contact::getPhone() const { return std::string_view(data() + nameLength, phoneLength); }
+std::string_view Contact::getEmail() const { return std::string_view(data() + nameLength + phoneLength, emailLength); }
 bool Contact::isFavorite() const { return favorite; }
 
-void Contact::setPhone(const std::string& phone) { this->phone = phone; }
-void Contact::setEmail(const std::string& email) { this->email = email; }
+void Contact::setPhone(std::string_view phone) { assign(getName(), phone, getEmail()); }
+void Contact::setEmail(std::string_view email) { assign(getName(), getPhone(), email); }
 void Contact::setFavorite(bool favorite) { this->favorite = favorite; }
 
 bool Contact::operator<(const Contact& other) const {
-    return name < other.name;
+    return getName() < other.getName();
 }
 
 bool Contact::operator==(const Contact& other) const {
-    return name == other.name;
+    return getName() == other.getName();
 }
 
 bool Contact::operator>(const Contact& other) const {
-    return name > other.name;
+    return getName() > other.getName();
 }
 
 void Contact::display() const {
-    std::cout << "📞 " << name << " | " << phone << " | " << email;
+    std::cout << "📞 " << getName() << " | " << getPhone() << " | " << getEmail();
     if (favorite) std::cout << " ⭐";
     std::cout << std::endl;
 }
\ No newline at end of file
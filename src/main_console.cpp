@@ -2,19 +2,47 @@
 #include <string>
 #include <limits>
 #include <cctype>
-#include <fstream>
-#include <sstream>
 #include "contact.h"
+#include "contact_csv.h"
+#include "contact_journal.h"
 #include "avl_tree.h"
+#include "bplus_tree.h"
 
 using namespace std;
 
+// Estrutura da agenda, escolhida na compilação: AVL (padrão) ou árvore B+
+// com -DAGENDA_BPLUS_TREE. As duas têm a mesma interface.
+#ifdef AGENDA_BPLUS_TREE
+using Agenda = BPlusTree<Contact>;
+#else
+using Agenda = AVLTree<Contact>;
+#endif
+
+// Snapshot e log da agenda (contact_journal.h)
+const string DataDirectory = "dados";
+// Arquivo sugerido para exportar e importar
+const string DefaultCsvFile = "contatos.csv";
+
+// Torna durável o que foi anotado no log (fsync a cada operação)
+void commitOrWarn(ContactJournal& journal) {
+    if (!journal.commit()) {
+        cout << " Erro: falha ao gravar em " << DataDirectory << "!" << endl;
+    }
+}
+
+// Campos acima de Contact::MaxFieldLength não cabem num contato
+bool checkFieldLength(const string& field) {
+    if (field.size() <= Contact::MaxFieldLength) return true;
+    cout << " Erro: Campo muito longo (máximo " << Contact::MaxFieldLength << " caracteres)!" << endl;
+    return false;
+}
+
 void clearInput() {
     cin.clear();
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
 }
 
-void pause() {
+void waitForEnter() {
     cout << "\nPressione Enter para continuar...";
     clearInput();
 }
@@ -38,7 +66,7 @@ void displayMenu() {
     cout << "Escolha uma opção: ";
 }
 
-void addContact(AVLTree<Contact>& agenda) {
+void addContact(Agenda& agenda, ContactJournal& journal) {
     string nome, telefone, email;
     char favorito;
     
@@ -50,26 +78,30 @@ void addContact(AVLTree<Contact>& agenda) {
         cout << " Erro: Nome é obrigatório!" << endl;
         return;
     }
+    if (!checkFieldLength(nome)) return;
     
     cout << "Telefone: ";
     getline(cin, telefone);
+    if (!checkFieldLength(telefone)) return;
     cout << "Email: ";
     getline(cin, email);
+    if (!checkFieldLength(email)) return;
     cout << "Favorito (s/n): ";
     cin >> favorito;
     clearInput();
     
     Contact novoContato(nome, telefone, email, toupper(favorito) == 'S');
     
-    if (agenda.contains(novoContato)) {
-        cout << " Erro: Contato já existe!" << endl;
-    } else {
-        agenda.insert(novoContato);
+    if (agenda.insert(novoContato)) {
+        journal.logPut(novoContato);
+        commitOrWarn(journal);
         cout << " Contato adicionado com sucesso!" << endl;
+    } else {
+        cout << " Erro: Contato já existe!" << endl;
     }
 }
 
-void removeContact(AVLTree<Contact>& agenda) {
+void removeContact(Agenda& agenda, ContactJournal& journal) {
     string nome;
     cout << "\n--- REMOVER CONTATO ---" << endl;
     cout << "Nome do contato a remover: ";
@@ -79,22 +111,25 @@ void removeContact(AVLTree<Contact>& agenda) {
         cout << " Erro: Digite um nome!" << endl;
         return;
     }
+    if (!checkFieldLength(nome)) return;
     
     Contact temp(nome, "", "");
     
-    if (agenda.contains(temp)) {
-        agenda.remove(temp);
+    if (agenda.remove(temp)) {
+        journal.logRemove(nome);
+        commitOrWarn(journal);
         cout << " Contato removido com sucesso!" << endl;
     } else {
         cout << " Erro: Contato não encontrado!" << endl;
     }
 }
 
-void searchContact(AVLTree<Contact>& agenda) {
+void searchContact(Agenda& agenda) {
     string nome;
     cout << "\n--- BUSCAR CONTATO ---" << endl;
     cout << "Nome: ";
     getline(cin, nome);
+    if (!checkFieldLength(nome)) return;
     
     Contact temp(nome, "", "");
     Contact* encontrado = agenda.search(temp);
@@ -108,22 +143,21 @@ void searchContact(AVLTree<Contact>& agenda) {
     }
 }
 
-void listAllContacts(AVLTree<Contact>& agenda) {
+void listAllContacts(Agenda& agenda) {
     cout << "\n--- TODOS OS CONTATOS ---" << endl;
-    auto contatos = agenda.inOrder();
     
-    if (contatos.empty()) {
+    if (agenda.isEmpty()) {
         cout << "Nenhum contato cadastrado." << endl;
     } else {
-        cout << "Total: " << contatos.size() << " contatos" << endl;
+        cout << "Total: " << agenda.size() << " contatos" << endl;
         cout << "────────────────────" << endl;
-        for (const auto& contato : contatos) {
+        for (const auto& contato : agenda) {
             contato.display();
         }
     }
 }
 
-void listFavorites(AVLTree<Contact>& agenda) {
+void listFavorites(Agenda& agenda) {
     cout << "\n--- CONTATOS FAVORITOS ---" << endl;
     auto favoritos = agenda.getFavorites();
     
@@ -138,107 +172,94 @@ void listFavorites(AVLTree<Contact>& agenda) {
     }
 }
 
-void toggleFavorite(AVLTree<Contact>& agenda) {
+void toggleFavorite(Agenda& agenda, ContactJournal& journal) {
     string nome;
     cout << "\n--- ALTERAR FAVORITO ---" << endl;
     cout << "Nome do contato: ";
     getline(cin, nome);
+    if (!checkFieldLength(nome)) return;
     
     Contact temp(nome, "", "");
-    Contact* encontrado = agenda.search(temp);
-    
-    if (encontrado) {
-        Contact atualizado = *encontrado;
-        atualizado.setFavorite(!atualizado.isFavorite());
-        
-        agenda.remove(*encontrado);
-        agenda.insert(atualizado);
-        
-        cout << " Contato " << (atualizado.isFavorite() ? "marcado" : "desmarcado") 
+    bool favorito = false;
+    
+    // Alteração no próprio nó, sem remover e reinserir
+    if (agenda.update(temp, [&](ContactDetails& contato) {
+            contato.setFavorite(!contato.isFavorite());
+            favorito = contato.isFavorite();
+        })) {
+        journal.logPut(*agenda.search(temp));
+        commitOrWarn(journal);
+        cout << " Contato " << (favorito ? "marcado" : "desmarcado") 
              << " como favorito!" << endl;
     } else {
         cout << " Erro: Contato não encontrado!" << endl;
     }
 }
 
-void showStatistics(AVLTree<Contact>& agenda) {
+void showStatistics(Agenda& agenda) {
     cout << "\n--- ESTATÍSTICAS DA ÁRVORE ---" << endl;
     cout << "✅ Árvore balanceada: " << (agenda.isBalanced() ? "Sim" : "Não") << endl;
     cout << "📊 Total de contatos: " << agenda.size() << endl;
-    cout << "⭐ Total de favoritos: " << agenda.getFavorites().size() << endl;
+    cout << "⭐ Total de favoritos: " << agenda.markedCount() << endl;
     cout << "🌳 Árvore vazia: " << (agenda.isEmpty() ? "Sim" : "Não") << endl;
 }
 
-void exportToCSV(const AVLTree<Contact>& agenda) {
-    ofstream file("contatos.csv");
-    if (!file.is_open()) {
-        cout << " Erro ao criar arquivo contatos.csv!" << endl;
+// Caminho do CSV; Enter usa DefaultCsvFile
+string askCsvPath() {
+    string path;
+    cout << "Arquivo CSV [" << DefaultCsvFile << "]: ";
+    getline(cin, path);
+    return path.empty() ? DefaultCsvFile : path;
+}
+
+void exportToCSV(const Agenda& agenda) {
+    string path = askCsvPath();
+    if (!writeContactsCsv(path, [&](const auto& visit) { agenda.forEach(visit); })) {
+        cout << " Erro ao gravar o arquivo " << path << "!" << endl;
         return;
     }
-    
-    // Cabeçalho
-    file << "Nome,Telefone,Email,Favorito\n";
-    
-    // Dados
-    auto contacts = agenda.inOrder();
-    for (const auto& contact : contacts) {
-        file << contact.getName() << ","
-             << contact.getPhone() << ","
-             << contact.getEmail() << ","
-             << (contact.isFavorite() ? "true" : "false") << "\n";
-    }
-    
-    file.close();
-    cout << " " << contacts.size() << " contatos exportados para contatos.csv" << endl;
+    cout << " " << agenda.size() << " contatos exportados para " << path << endl;
 }
 
-void importFromCSV(AVLTree<Contact>& agenda) {
-    ifstream file("contatos.csv");
-    if (!file.is_open()) {
-        cout << " Arquivo contatos.csv não encontrado!" << endl;
+void importFromCSV(Agenda& agenda, ContactJournal& journal) {
+    string path = askCsvPath();
+    CsvImport csv = readContactsCsv(path);
+    if (!csv.opened) {
+        cout << " Arquivo " << path << " não encontrado!" << endl;
         cout << " Exporte primeiro alguns contatos para criar o arquivo." << endl;
         return;
     }
+    if (!csv.ok) {
+        cout << " Arquivo inválido: registro " << csv.invalidRecord << " mal formado (aspas?)." << endl;
+        return;
+    }
     
-    string line;
-    getline(file, line); // Pular cabeçalho
-    
-    int imported = 0;
-    int skipped = 0;
+    // Todos os registros inseridos de uma vez: uma ordenação e uma
+    // reconstrução em O(n) em vez de uma inserção com rotações por linha
+    int total = csv.contacts.size();
+    int imported = agenda.insertBulk(csv.contacts);
+    int skipped = total - imported;
     
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string name, phone, email, favoriteStr;
-        
-        getline(ss, name, ',');
-        getline(ss, phone, ',');
-        getline(ss, email, ',');
-        getline(ss, favoriteStr, ',');
-        
-        if (!name.empty()) {
-            bool favorite = (favoriteStr == "true");
-            Contact newContact(name, phone, email, favorite);
-            
-            if (!agenda.contains(newContact)) {
-                agenda.insert(newContact);
-                imported++;
-            } else {
-                skipped++;
-            }
-        }
+    // O log recebe o contato que ficou na agenda para cada nome importado
+    // (reaplicar um que já existia não muda nada)
+    for (const Contact& row : csv.contacts) {
+        journal.logPut(*agenda.search(row));
     }
+    commitOrWarn(journal);
     
-    file.close();
     cout << " " << imported << " contatos importados!" << endl;
     if (skipped > 0) {
         cout << " " << skipped << " contatos duplicados foram ignorados." << endl;
     }
+    if (csv.skipped > 0) {
+        cout << " " << csv.skipped << " linhas sem nome ou com campos longos demais foram ignoradas." << endl;
+    }
 }
 
 void runTests() {
     cout << "\n--- EXECUTANDO TESTES ---" << endl;
     
-    AVLTree<Contact> testTree;
+    Agenda testTree;
     
     // Teste de inserção
     testTree.insert(Contact("Alice", "111", "alice@email.com", true));
@@ -273,18 +294,38 @@ void runTests() {
 }
 
 int main() {
-    AVLTree<Contact> agenda;
+    Agenda agenda;
     int opcao;
     
-    // Adicionar alguns contatos de exemplo
-    agenda.insert(Contact("Ana Silva", "11-1111-1111", "ana@email.com", true));
-    agenda.insert(Contact("Carlos Oliveira", "11-2222-2222", "carlos@email.com"));
-    agenda.insert(Contact("Beatriz Santos", "11-3333-3333", "beatriz@email.com", true));
-    agenda.insert(Contact("Daniel Costa", "11-4444-4444", "daniel@email.com"));
-    agenda.insert(Contact("Eduarda Lima", "11-5555-5555", "eduarda@email.com", true));
+    // Carrega o último snapshot e reaplica o log por cima
+    ContactJournal journal(DataDirectory, ContactJournal::Durability::PerOperation);
+    bool recovered = journal.recover([&](const ContactSnapshot& snapshot) { agenda.insertBulk(snapshot.contacts()); },
+                                     [&](const Contact& contact) { agenda.upsert(contact); },
+                                     [&](string_view name) { agenda.remove(Contact(name)); });
+    if (!recovered || !journal.open()) {
+        cerr << " Erro: nao foi possivel abrir os dados em " << DataDirectory << endl;
+        return 1;
+    }
+    ContactJournal::Source source = [&](ContactSnapshot::Writer& writer) {
+        agenda.forEach([&](const Contact& contact) { writer.add(contact); });
+    };
+    if (journal.logSize() > 0) journal.checkpoint(source);
+    
+    if (journal.isNew()) {
+        // Adicionar alguns contatos de exemplo
+        for (const Contact& contact : {Contact("Ana Silva", "11-1111-1111", "ana@email.com", true),
+                                       Contact("Carlos Oliveira", "11-2222-2222", "carlos@email.com"),
+                                       Contact("Beatriz Santos", "11-3333-3333", "beatriz@email.com", true),
+                                       Contact("Daniel Costa", "11-4444-4444", "daniel@email.com"),
+                                       Contact("Eduarda Lima", "11-5555-5555", "eduarda@email.com", true)}) {
+            agenda.insert(contact);
+            journal.logPut(contact);
+        }
+        commitOrWarn(journal);
+    }
     
     cout << " SISTEMA DE AGENDA AVL INICIADO!" << endl;
-    cout << " " << agenda.size() << " contatos de exemplo carregados" << endl;
+    cout << " " << agenda.size() << " contatos carregados de " << DataDirectory << endl;
     
     do {
         displayMenu();
@@ -292,23 +333,25 @@ int main() {
         clearInput();
         
         switch (opcao) {
-            case 1: addContact(agenda); break;
-            case 2: removeContact(agenda); break;
+            case 1: addContact(agenda, journal); break;
+            case 2: removeContact(agenda, journal); break;
             case 3: searchContact(agenda); break;
             case 4: listAllContacts(agenda); break;
             case 5: listFavorites(agenda); break;
-            case 6: toggleFavorite(agenda); break;
+            case 6: toggleFavorite(agenda, journal); break;
             case 7: showStatistics(agenda); break;
             case 8: runTests(); break;
             case 9: exportToCSV(agenda); break;
-            case 10: importFromCSV(agenda); break;
+            case 10: importFromCSV(agenda, journal); break;
             case 11: cout << " Saindo... Até logo!" << endl; break;
             default: cout << " Opção inválida!" << endl;
         }
         
-        if (opcao != 11) pause();
+        if (opcao != 11) waitForEnter();
         
     } while (opcao != 11);
     
+    // Log compactado num snapshot para a próxima partida
+    journal.checkpoint(source);
     return 0;
 }
\ No newline at end of file
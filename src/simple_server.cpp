@@ -1,326 +1,581 @@
 #include <iostream>
 #include <string>
 #include <sstream>
-#include <fstream>
-#include <winsock2.h>
-#include <ws2tcpip.h>
-#pragma comment(lib, "ws2_32.lib")
+#include <vector>
+#include <cctype>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 
-#include "avl_tree.h"
+#include "contact_journal.h"
+#include "contact_scan.h"
+#include "contact_store.h"
+#include "fuzzy_index.h"
+#include "http_router.h"
+#include "json_reader.h"
+#include "json_writer.h"
+#include "http_server.h"
+#include "static_assets.h"
+#include "collation.h"
 #include "contact.h"
 
 using namespace std;
 
+// Ordem dos nomes na agenda: sem distinção de maiúsculas e acentos.
+// Compile com -DAGENDA_BINARY_COLLATION para a ordem byte a byte.
+#ifdef AGENDA_BINARY_COLLATION
+using AgendaCollation = BinaryCollation;
+#else
+using AgendaCollation = FoldedCollation;
+#endif
+
+using Agenda = ContactStore<ContactOrder<AgendaCollation>>;
+
+// Rotas e respostas da agenda. A rede fica com HttpServer, que chama
+// handleRequest de várias threads ao mesmo tempo e cuida de Content-Length
+// e Connection nas respostas; a tabela de rotas é montada no construtor.
 class SimpleWebServer {
 private:
-    SOCKET serverSocket;
-    AVLTree<Contact> agenda;
+    // Índices por nome, telefone e email. Cada escrita publica uma nova
+    // versão; leitores usam snapshots sem bloqueio e nunca seguram os escritores
+    Agenda agenda;
+    // Log e snapshots em disco; cada escrita é anotada pelo listener
+    // da agenda e confirmada (commit) antes da resposta
+    unique_ptr<ContactJournal> journal;
+    // Cópia colunar da última versão consultada por /api/search?q=,
+    // reconstruída quando a agenda muda (fora de scanMutex, uma por vez)
+    shared_ptr<const ContactScanIndex> scanIndex;
+    Agenda::Snapshot scanVersion;
+    bool scanBuilding = false;
+    mutex scanMutex;
+    // Trigramas de nomes e emails para /api/search?fuzzy=1, atualizado a
+    // cada escrita na agenda
+    FuzzyIndex fuzzy;
+    shared_mutex fuzzyMutex;
+    HttpRouter router;
+    // web/ em memória, com gzip e ETag
+    StaticAssets assets;
+    mutex logMutex;
 
 public:
-    SimpleWebServer() : serverSocket(INVALID_SOCKET) {
-        // Dados de exemplo
-        agenda.insert(Contact("Ana Silva", "11-1111-1111", "ana@email.com", true));
-        agenda.insert(Contact("Carlos Oliveira", "11-2222-2222", "carlos@email.com"));
-        agenda.insert(Contact("Beatriz Santos", "11-3333-3333", "beatriz@email.com", true));
-        agenda.insert(Contact("Daniel Costa", "11-4444-4444", "daniel@email.com"));
-        agenda.insert(Contact("Eduarda Lima", "11-5555-5555", "eduarda@email.com", true));
-    }
+    bool logRequests = true;
 
-    bool start(int port = 8080) {
-        WSADATA wsaData;
-        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
-            cerr << "Falha ao inicializar Winsock" << endl;
-            return false;
-        }
+    SimpleWebServer() {
+        addRoutes();
+    }
 
-        serverSocket = socket(AF_INET, SOCK_STREAM, 0);
-        if (serverSocket == INVALID_SOCKET) {
-            cerr << "Erro ao criar socket" << endl;
-            return false;
-        }
+    // Carrega a agenda de directory (snapshot e log) e passa a gravar nele
+    // as escritas. Uma agenda nova começa com os contatos de exemplo.
+    bool openData(const string& directory, ContactJournal::Durability durability) {
+        journal = make_unique<ContactJournal>(directory, durability);
+        vector<pair<Contact, bool>> logTail; // (contato, removido)
+        bool recovered = journal->recover(
+            [&](const ContactSnapshot& snapshot) {
+                if (agenda.assign(snapshot)) return;
+                // Gravado com outra ordem de nomes: um a um
+                agenda.modify([&](Agenda::Transaction& tx) {
+                    for (size_t i = 0; i < snapshot.size(); i++) tx.upsert(snapshot[i].toContact());
+                    return true;
+                });
+            },
+            [&](const Contact& contact) { logTail.emplace_back(contact, false); },
+            [&](string_view name) { logTail.emplace_back(Contact(name), true); });
+        if (!recovered || !journal->open()) return false;
+        // O log depois do snapshot, numa transação só
+        agenda.modify([&](Agenda::Transaction& tx) {
+            for (const auto& [contact, removed] : logTail) {
+                if (removed) {
+                    tx.remove(contact);
+                } else {
+                    tx.upsert(contact);
+                }
+            }
+            return !logTail.empty();
+        });
 
-        sockaddr_in serverAddr;
-        serverAddr.sin_family = AF_INET;
-        serverAddr.sin_addr.s_addr = INADDR_ANY;
-        serverAddr.sin_port = htons(port);
+        agenda.snapshot().forEach([&](const Contact& contact) {
+            fuzzy.set(contact.getName(), contact.getEmail());
+        });
+        agenda.setChangeListener([this](const Contact* before, const Contact* after) {
+            if (after) {
+                journal->logPut(*after);
+            } else {
+                journal->logRemove(before->getName());
+            }
+            unique_lock<shared_mutex> lock(fuzzyMutex);
+            if (after) {
+                fuzzy.set(after->getName(), after->getEmail());
+            } else {
+                fuzzy.remove(before->getName());
+            }
+        });
 
-        if (bind(serverSocket, (sockaddr*)&serverAddr, sizeof(serverAddr)) == SOCKET_ERROR) {
-            cerr << "Erro no bind" << endl;
-            return false;
-        }
+        ContactJournal::Source source = [this](ContactSnapshot::Writer& writer) {
+            agenda.snapshot().writeTo(writer);
+        };
+        journal->setCheckpointSource(source);
+        // Log reaplicado vira snapshot já na partida
+        if (journal->logSize() > 0 && !journal->checkpoint(source)) return false;
 
-        if (listen(serverSocket, 10) == SOCKET_ERROR) {
-            cerr << "Erro no listen" << endl;
-            return false;
+        if (journal->isNew()) {
+            // Dados de exemplo
+            agenda.insert(Contact("Ana Silva", "11-1111-1111", "ana@email.com", true));
+            agenda.insert(Contact("Carlos Oliveira", "11-2222-2222", "carlos@email.com"));
+            agenda.insert(Contact("Beatriz Santos", "11-3333-3333", "beatriz@email.com", true));
+            agenda.insert(Contact("Daniel Costa", "11-4444-4444", "daniel@email.com"));
+            agenda.insert(Contact("Eduarda Lima", "11-5555-5555", "eduarda@email.com", true));
         }
-
-        cout << "Servidor rodando na porta " << port << endl;
-        cout << "Acesse: http://localhost:" << port << endl;
-        return true;
+        return journal->commit();
     }
 
-    string readFile(const string& filename) {
-        ifstream file(filename, ios::binary);
-        if (!file.is_open()) {
-            return "";
+    void addRoutes() {
+        // Arquivos estáticos
+        for (const char* file : {"web/index.html", "web/style.css", "web/script.js"}) {
+            assets.preload(file);
         }
-        
-        string content;
-        file.seekg(0, ios::end);
-        content.resize(file.tellg());
-        file.seekg(0, ios::beg);
-        file.read(&content[0], content.size());
-        file.close();
-        
-        return content;
-    }
+        router.add("GET", "/", [this](const RouteRequest& r) { return assets.serve("web/index.html", r.http); });
+        router.add("GET", "/index.html", [this](const RouteRequest& r) { return assets.serve("web/index.html", r.http); });
+        router.add("GET", "/style.css", [this](const RouteRequest& r) { return assets.serve("web/style.css", r.http); });
+        router.add("GET", "/script.js", [this](const RouteRequest& r) { return assets.serve("web/script.js", r.http); });
 
-    string getContentType(const string& filename) {
-        if (filename.find(".html") != string::npos) return "text/html; charset=utf-8";
-        if (filename.find(".css") != string::npos) return "text/css";
-        if (filename.find(".js") != string::npos) return "application/javascript";
-        if (filename.find(".json") != string::npos) return "application/json";
-        return "text/plain";
+        // API
+        router.add("GET", "/api/contacts", [this](const RouteRequest& r) { return handleListContacts(r); });
+        router.add("GET", "/api/contacts/:name", [this](const RouteRequest& r) { return handleGetContact(r); });
+        router.add("GET", "/api/statistics", [this](const RouteRequest&) { return generateStatisticsJSON(); });
+        router.add("GET", "/api/search", [this](const RouteRequest& r) { return handleSearch(r); });
+        router.add("GET", "/api/range", [this](const RouteRequest& r) { return handleRange(r); });
+        router.add("GET", "/api/lookup", [this](const RouteRequest& r) { return handleLookup(r); });
+        router.add("POST", "/api/add", [this](const RouteRequest& r) { return handleOperation(r, "add"); });
+        router.add("POST", "/api/remove", [this](const RouteRequest& r) { return handleOperation(r, "remove"); });
+        router.add("POST", "/api/toggle-favorite", [this](const RouteRequest& r) { return handleOperation(r, "toggle-favorite"); });
+        router.add("POST", "/api/update", [this](const RouteRequest& r) { return handleOperation(r, "update"); });
+        router.add("POST", "/api/batch", [this](const RouteRequest& r) { return handleBatch(r); });
     }
 
-    void handleRequests() {
-        while (true) {
-            SOCKET clientSocket = accept(serverSocket, NULL, NULL);
-            if (clientSocket == INVALID_SOCKET) {
-                cerr << "Erro no accept" << endl;
-                continue;
-            }
-
-            char buffer[4096];
-            int bytesReceived = recv(clientSocket, buffer, sizeof(buffer), 0);
-            
-            if (bytesReceived > 0) {
-                string request(buffer, bytesReceived);
-                string response = handleRequest(request);
-                send(clientSocket, response.c_str(), response.length(), 0);
-            }
-
-            closesocket(clientSocket);
+    HttpResponse handleRequest(const HttpRequest& request) {
+        if (logRequests) {
+            lock_guard<mutex> lock(logMutex);
+            cout << "Requisição: " << request.method << " " << request.target << " " << request.version << endl;
         }
+        return router.dispatch(request);
     }
 
-    string handleRequest(const string& request) {
-        cout << "Requisição: " << request.substr(0, request.find('\n')) << endl;
+    // GET /api/contacts?limit=...&offset=...  ou  ?limit=...&cursor=...
+    // Uma página (até 1000) em ordem de nome, escrita direto da árvore para
+    // o buffer da resposta. offset começa na posição dada, achada em
+    // O(log n) pelas contagens dos nós; cursor (o "next" da página
+    // anterior) continua depois daquele nome mesmo com escritas entre as
+    // páginas. "next" é null na última página.
+    HttpResponse handleListContacts(const RouteRequest& request) {
+        int limit = getLimitParam(request, 1000);
+        string cursor = request.query("cursor");
+        int offset = max(0, atoi(request.query("offset").c_str()));
+        auto snapshot = agenda.snapshot();
 
-        // Servir arquivos estáticos
-        if (request.find("GET / ") != string::npos || request.find("GET /index.html") != string::npos) {
-            return serveStaticFile("web/index.html");
-        }
-        else if (request.find("GET /style.css") != string::npos) {
-            return serveStaticFile("web/style.css");
-        }
-        else if (request.find("GET /script.js") != string::npos) {
-            return serveStaticFile("web/script.js");
-        }
-        else if (request.find("GET /api/contacts") != string::npos) {
-            return generateContactsJSON();
-        }
-        else if (request.find("POST /api/add") != string::npos) {
-            return handleAddContact(request);
-        }
-        else if (request.find("POST /api/remove") != string::npos) {
-            return handleRemoveContact(request);
-        }
-        else if (request.find("POST /api/toggle-favorite") != string::npos) {
-            return handleToggleFavorite(request);
-        }
-        else if (request.find("GET /api/statistics") != string::npos) {
-            return generateStatisticsJSON();
+        string body;
+        body.reserve(128 + 96 * (size_t)min(limit, snapshot.size()));
+        JsonWriter json(body);
+        json.beginObject().key("success").value(true).key("contacts").beginArray();
+        int count = 0;
+        const Contact* last = nullptr;
+        bool more = false;
+        auto visit = [&](const Contact& c) {
+            if (count == limit) {
+                more = true;
+                return false;
+            }
+            writeContact(json, c);
+            last = &c;
+            count++;
+            return true;
+        };
+        if (!cursor.empty()) {
+            snapshot.byName().visitAfter(Contact(cursor), visit);
+        } else {
+            snapshot.byName().visitFromRank(offset, visit);
         }
-        else {
-            return "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\n\r\n404 - Pagina nao encontrada";
+        json.endArray().key("count").value(count).key("total").value(snapshot.size()).key("next");
+        if (more) {
+            json.value(last->getName());
+        } else {
+            json.null();
         }
+        json.endObject();
+        return jsonResponse(move(body));
     }
 
-    string serveStaticFile(const string& filename) {
-        string content = readFile(filename);
-        if (content.empty()) {
-            return "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\n\r\nArquivo nao encontrado: " + filename;
-        }
+    void writeContact(JsonWriter& json, const Contact& contact) {
+        json.beginObject()
+            .key("name").value(contact.getName())
+            .key("phone").value(contact.getPhone())
+            .key("email").value(contact.getEmail())
+            .key("favorite").value(contact.isFavorite())
+            .endObject();
+    }
 
-        string contentType = getContentType(filename);
-        string response = "HTTP/1.1 200 OK\r\n";
-        response += "Content-Type: " + contentType + "\r\n";
-        response += "Content-Length: " + to_string(content.length()) + "\r\n";
-        response += "Connection: close\r\n\r\n";
-        response += content;
+    // Resposta 200 com o JSON como corpo compartilhado, enviado sem cópia
+    HttpResponse jsonResponse(string body) {
+        return HttpResponse("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n\r\n",
+                            make_shared<const string>(move(body)));
+    }
 
-        return response;
+    // {"success":true,"contacts":[...],"count":n} com os contatos que
+    // fill escrever por meio de add
+    template<typename Fill>
+    HttpResponse contactListResponse(Fill fill) {
+        string body;
+        JsonWriter json(body);
+        json.beginObject().key("success").value(true).key("contacts").beginArray();
+        int count = 0;
+        fill([&](const Contact& c) {
+            writeContact(json, c);
+            count++;
+        });
+        json.endArray().key("count").value(count).endObject();
+        return jsonResponse(move(body));
     }
 
-    string generateContactsJSON() {
-        auto contacts = agenda.inOrder();
-        string json = "{\"success\":true,\"contacts\":[";
-        
-        for (size_t i = 0; i < contacts.size(); i++) {
-            if (i > 0) json += ",";
-            json += "{";
-            json += "\"name\":\"" + escapeJSON(contacts[i].getName()) + "\",";
-            json += "\"phone\":\"" + escapeJSON(contacts[i].getPhone()) + "\",";
-            json += "\"email\":\"" + escapeJSON(contacts[i].getEmail()) + "\",";
-            json += "\"favorite\":" + string(contacts[i].isFavorite() ? "true" : "false");
-            json += "}";
+    // GET /api/contacts/{nome}
+    // Um contato pelo nome exato, O(log n)
+    HttpResponse handleGetContact(const RouteRequest& request) {
+        auto snapshot = agenda.snapshot();
+        const Contact* contact = snapshot.search(Contact(request.param("name")));
+        if (!contact) {
+            return "HTTP/1.1 404 Not Found\r\nContent-Type: application/json\r\n\r\n{\"success\":false,\"message\":\"Contato nao encontrado\"}";
         }
         
-        json += "]}";
-        
-        return "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " + 
-               to_string(json.length()) + "\r\n\r\n" + json;
+        string body;
+        JsonWriter json(body);
+        json.beginObject().key("success").value(true).key("contact");
+        writeContact(json, *contact);
+        json.endObject();
+        return jsonResponse(move(body));
     }
 
-    string generateStatisticsJSON() {
-        auto contacts = agenda.inOrder();
-        auto favorites = agenda.getFavorites();
-        
-        string json = "{\"success\":true,\"statistics\":{";
-        json += "\"total\":" + to_string(contacts.size()) + ",";
-        json += "\"favorites\":" + to_string(favorites.size()) + ",";
-        json += "\"balanced\":" + string(agenda.isBalanced() ? "true" : "false");
-        json += "}}";
+    // GET /api/search?prefix=...&limit=...
+    // Nomes que começam com o prefixo (segundo a colação), O(log n + k)
+    // GET /api/search?q=...&limit=...
+    // Trecho em qualquer parte do nome, telefone ou email (varredura)
+    // GET /api/search?q=...&fuzzy=1&limit=...
+    // Nomes/emails parecidos com q (erros de digitação), do mais próximo
+    HttpResponse handleSearch(const RouteRequest& request) {
+        string query = request.query("q");
+        string prefix = request.query("prefix");
+        int limit = getLimitParam(request);
         
-        return "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " + 
-               to_string(json.length()) + "\r\n\r\n" + json;
+        auto snapshot = agenda.snapshot();
+        return contactListResponse([&](auto add) {
+            if (!query.empty() && request.query("fuzzy") == "1") {
+                vector<string> names;
+                {
+                    shared_lock<shared_mutex> lock(fuzzyMutex);
+                    fuzzy.search(query, limit, [&](string_view name, int) { names.emplace_back(name); });
+                }
+                for (const string& name : names) {
+                    const Contact* c = snapshot.search(Contact(name));
+                    if (c) add(*c); // Senão, removido depois da busca
+                }
+            } else if (!query.empty()) {
+                getScanIndex(snapshot)->search(query, add, limit);
+            } else {
+                int found = 0;
+                snapshot.byName().visitFrom(
+                    [&](const Contact& c) { return AgendaCollation::comparePrimary(c.getName(), prefix) < 0; },
+                    [&](const Contact& c) {
+                        if (found == limit || !AgendaCollation::hasPrefix(c.getName(), prefix)) return false;
+                        add(c);
+                        found++;
+                        return true;
+                    });
+            }
+        });
     }
 
-    string handleAddContact(const string& request) {
-        size_t jsonStart = request.find("\r\n\r\n");
-        if (jsonStart == string::npos) {
-            return "HTTP/1.1 400 Bad Request\r\nContent-Type: application/json\r\n\r\n{\"success\":false,\"message\":\"JSON nao encontrado\"}";
+    // A busca que encontra a cópia desatualizada a reconstrui sem segurar
+    // scanMutex; as que chegam enquanto isso usam a versão anterior
+    shared_ptr<const ContactScanIndex> getScanIndex(const Agenda::Snapshot& snapshot) {
+        unique_lock<mutex> lock(scanMutex);
+        if (scanIndex && (scanBuilding || scanVersion.sameVersion(snapshot))) return scanIndex;
+        scanBuilding = true;
+        lock.unlock();
+        shared_ptr<const ContactScanIndex> built;
+        try {
+            built = make_shared<const ContactScanIndex>(snapshot);
+        } catch (...) {
+            lock.lock();
+            scanBuilding = false;
+            throw;
         }
-        
-        string jsonBody = request.substr(jsonStart + 4);
-        string name = extractJSONValue(jsonBody, "name");
-        string phone = extractJSONValue(jsonBody, "phone");
-        string email = extractJSONValue(jsonBody, "email");
-        string favoriteStr = extractJSONValue(jsonBody, "favorite");
-        bool favorite = (favoriteStr == "true");
-        
-        if (name.empty()) {
-            return "HTTP/1.1 400 Bad Request\r\nContent-Type: application/json\r\n\r\n{\"success\":false,\"message\":\"Nome e obrigatorio\"}";
-        }
-        
-        Contact newContact(name, phone, email, favorite);
-        
-        if (agenda.contains(newContact)) {
-            return "HTTP/1.1 400 Bad Request\r\nContent-Type: application/json\r\n\r\n{\"success\":false,\"message\":\"Contato ja existe\"}";
-        }
-        
-        agenda.insert(newContact);
-        
-        return "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n\r\n{\"success\":true,\"message\":\"Contato adicionado com sucesso\"}";
+        lock.lock();
+        scanBuilding = false;
+        scanIndex = built;
+        scanVersion = snapshot;
+        return built;
     }
 
-    string handleRemoveContact(const string& request) {
-        size_t jsonStart = request.find("\r\n\r\n");
-        if (jsonStart == string::npos) {
-            return "HTTP/1.1 400 Bad Request\r\nContent-Type: application/json\r\n\r\n{\"success\":false,\"message\":\"JSON nao encontrado\"}";
-        }
+    // GET /api/range?from=...&to=...&limit=...
+    // Nomes em [from, to) segundo a colação; sem "to", vai até o fim
+    HttpResponse handleRange(const RouteRequest& request) {
+        string from = request.query("from");
+        string to = request.query("to");
+        int limit = getLimitParam(request);
         
-        string jsonBody = request.substr(jsonStart + 4);
-        string name = extractJSONValue(jsonBody, "name");
-        
-        if (name.empty()) {
-            return "HTTP/1.1 400 Bad Request\r\nContent-Type: application/json\r\n\r\n{\"success\":false,\"message\":\"Nome e obrigatorio\"}";
-        }
-        
-        Contact temp(name, "", "");
-        
-        if (!agenda.contains(temp)) {
-            return "HTTP/1.1 404 Not Found\r\nContent-Type: application/json\r\n\r\n{\"success\":false,\"message\":\"Contato nao encontrado\"}";
-        }
-        
-        agenda.remove(temp);
-        
-        return "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n\r\n{\"success\":true,\"message\":\"Contato removido com sucesso\"}";
+        auto snapshot = agenda.snapshot();
+        return contactListResponse([&](auto add) {
+            int found = 0;
+            snapshot.byName().visitFrom(
+                [&](const Contact& c) { return AgendaCollation::comparePrimary(c.getName(), from) < 0; },
+                [&](const Contact& c) {
+                    if (found == limit) return false;
+                    if (!to.empty() && AgendaCollation::comparePrimary(c.getName(), to) >= 0) return false;
+                    add(c);
+                    found++;
+                    return true;
+                });
+        });
     }
 
-    string handleToggleFavorite(const string& request) {
-        size_t jsonStart = request.find("\r\n\r\n");
-        if (jsonStart == string::npos) {
-            return "HTTP/1.1 400 Bad Request\r\nContent-Type: application/json\r\n\r\n{\"success\":false,\"message\":\"JSON nao encontrado\"}";
+    // GET /api/lookup?phone=...  ou  GET /api/lookup?email=...
+    // Busca exata pelos índices secundários, O(log n + k). O telefone é
+    // comparado só pelos dígitos e o email sem distinção de maiúsculas.
+    HttpResponse handleLookup(const RouteRequest& request) {
+        string phone = request.query("phone");
+        string email = request.query("email");
+        if (phone.empty() && email.empty()) {
+            return "HTTP/1.1 400 Bad Request\r\nContent-Type: application/json\r\n\r\n{\"success\":false,\"message\":\"Informe phone ou email\"}";
         }
         
-        string jsonBody = request.substr(jsonStart + 4);
-        string name = extractJSONValue(jsonBody, "name");
-        
-        if (name.empty()) {
-            return "HTTP/1.1 400 Bad Request\r\nContent-Type: application/json\r\n\r\n{\"success\":false,\"message\":\"Nome e obrigatorio\"}";
-        }
-        
-        Contact temp(name, "", "");
-        Contact* found = agenda.search(temp);
-        
-        if (!found) {
-            return "HTTP/1.1 404 Not Found\r\nContent-Type: application/json\r\n\r\n{\"success\":false,\"message\":\"Contato nao encontrado\"}";
-        }
-        
-        Contact updated = *found;
-        updated.setFavorite(!updated.isFavorite());
-        
-        agenda.remove(*found);
-        agenda.insert(updated);
-        
-        return "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n\r\n{\"success\":true,\"message\":\"Favorito atualizado\"}";
+        auto snapshot = agenda.snapshot();
+        vector<Contact> found = phone.empty() ? snapshot.findByEmail(email) : snapshot.findByPhone(phone);
+        return contactListResponse([&](auto add) {
+            for (const Contact& c : found) add(c);
+        });
     }
 
-    string extractJSONValue(const string& json, const string& key) {
-        string searchStr = "\"" + key + "\":\"";
-        size_t start = json.find(searchStr);
-        if (start == string::npos) {
-            // Tentar encontrar valor boolean
-            searchStr = "\"" + key + "\":";
-            start = json.find(searchStr);
-            if (start == string::npos) return "";
-            
-            start += searchStr.length();
-            size_t end = json.find_first_of(",}", start);
-            if (end == string::npos) return "";
-            
-            return json.substr(start, end - start);
-        }
-        
-        start += searchStr.length();
-        size_t end = json.find("\"", start);
-        if (end == string::npos) return "";
+    int getLimitParam(const RouteRequest& request, int defaultLimit = 50) {
+        const int maxLimit = 1000;
+        string value = request.query("limit");
+        int limit = value.empty() ? defaultLimit : atoi(value.c_str());
+        if (limit <= 0) return defaultLimit;
+        return limit > maxLimit ? maxLimit : limit;
+    }
+
+    HttpResponse generateStatisticsJSON() {
+        // Total e favoritos vêm da mesma versão e são contados nos próprios
+        // nós, em O(1)
+        auto snapshot = agenda.snapshot();
         
-        return json.substr(start, end - start);
+        string body;
+        JsonWriter json(body);
+        json.beginObject().key("success").value(true).key("statistics").beginObject()
+            .key("total").value(snapshot.size())
+            .key("favorites").value(snapshot.favoriteCount())
+            .endObject().endObject();
+        return jsonResponse(move(body));
+    }
+
+    // Uma escrita: o corpo de /api/add, /api/remove, /api/toggle-favorite
+    // e /api/update, ou um item de /api/batch (com "op")
+    struct Operation {
+        string op;
+        string name, phone, email;
+        bool favorite = false;
+        bool hasPhone = false, hasEmail = false, hasFavorite = false;
+    };
+
+    struct OperationResult {
+        int status; // 200, 400 ou 404
+        const char* message;
+    };
+
+    // Campos de um objeto JSON; os desconhecidos são ignorados
+    static bool readOperation(JsonReader& json, Operation& operation) {
+        return json.forEachField([&](string_view key) {
+            if (key == "op") return json.readString(operation.op);
+            if (key == "name") return json.readString(operation.name);
+            if (key == "phone") return operation.hasPhone = json.readString(operation.phone);
+            if (key == "email") return operation.hasEmail = json.readString(operation.email);
+            if (key == "favorite") return operation.hasFavorite = json.readBool(operation.favorite);
+            return json.skip();
+        });
     }
 
-    string escapeJSON(const string& input) {
-        string output;
-        for (char c : input) {
-            if (c == '"') output += "\\\"";
-            else if (c == '\\') output += "\\\\";
-            else if (c == '\b') output += "\\b";
-            else if (c == '\f') output += "\\f";
-            else if (c == '\n') output += "\\n";
-            else if (c == '\r') output += "\\r";
-            else if (c == '\t') output += "\\t";
-            else output += c;
+    static OperationResult apply(Agenda::Transaction& tx, const Operation& operation) {
+        if (operation.name.empty()) return {400, "Nome e obrigatorio"};
+        try {
+            if (operation.op == "add") {
+                Contact contact(operation.name, operation.phone, operation.email, operation.favorite);
+                if (!tx.insert(contact)) return {400, "Contato ja existe"};
+                return {200, "Contato adicionado com sucesso"};
+            }
+
+            Contact key(operation.name);
+            if (operation.op == "remove") {
+                if (!tx.remove(key)) return {404, "Contato nao encontrado"};
+                return {200, "Contato removido com sucesso"};
+            }
+            if (operation.op == "toggle-favorite") {
+                // Só o caminho até o contato é copiado; índices não mudam
+                bool found = tx.update(key, [](ContactDetails& contact) {
+                    contact.setFavorite(!contact.isFavorite());
+                });
+                if (!found) return {404, "Contato nao encontrado"};
+                return {200, "Favorito atualizado"};
+            }
+            if (operation.op == "update") {
+                // Só os campos presentes mudam
+                bool found = tx.update(key, [&](ContactDetails& contact) {
+                    if (operation.hasPhone) contact.setPhone(operation.phone);
+                    if (operation.hasEmail) contact.setEmail(operation.email);
+                    if (operation.hasFavorite) contact.setFavorite(operation.favorite);
+                });
+                if (!found) return {404, "Contato nao encontrado"};
+                return {200, "Contato atualizado"};
+            }
+            return {400, "Operacao desconhecida"};
+        } catch (const length_error&) {
+            return {400, "Campo muito longo"};
         }
-        return output;
     }
 
-    ~SimpleWebServer() {
-        if (serverSocket != INVALID_SOCKET) {
-            closesocket(serverSocket);
+    // {"success":...,"message":...} com o status dado
+    static HttpResponse messageResponse(int status, const char* message) {
+        string body;
+        JsonWriter json(body);
+        json.beginObject().key("success").value(status == 200).key("message").value(message).endObject();
+        const char* reason = status == 200 ? "OK" : status == 404 ? "Not Found" :
+                             status == 500 ? "Internal Server Error" :
+                             status == 503 ? "Service Unavailable" : "Bad Request";
+        return "HTTP/1.1 " + to_string(status) + " " + reason + "\r\nContent-Type: application/json\r\n\r\n" + body;
+    }
+
+    // Alteração já publicada na agenda cujo commit no log falhou: os
+    // leitores a veem, mas ela se perde ao reiniciar
+    static HttpResponse notPersistedResponse() {
+        string body;
+        JsonWriter json(body);
+        json.beginObject().key("success").value(false).key("applied").value(true).key("persisted").value(false)
+            .key("message").value("Alteracao aplicada, mas nao gravada em disco").endObject();
+        return "HTTP/1.1 500 Internal Server Error\r\nContent-Type: application/json\r\n\r\n" + body;
+    }
+
+    // POST /api/add {"name":..., "phone":..., "email":..., "favorite":...}
+    // POST /api/remove e /api/toggle-favorite {"name":...}
+    // POST /api/update {"name":..., e os campos a alterar}
+    // Como em handleBatch: 503 sem aplicar se o log já falhou, e 500 com
+    // "applied":true, "persisted":false se o commit desta falhar.
+    HttpResponse handleOperation(const RouteRequest& request, const char* op) {
+        if (request.body().empty()) return messageResponse(400, "JSON nao encontrado");
+        Operation operation;
+        JsonReader json(request.body());
+        if (!readOperation(json, operation) || !json.atEnd()) return messageResponse(400, "JSON invalido");
+        operation.op = op;
+        if (journal->hasFailed()) return messageResponse(503, "Gravacao indisponivel");
+
+        OperationResult result{400, ""};
+        bool changed = agenda.modify([&](Agenda::Transaction& tx) {
+            result = apply(tx, operation);
+            return result.status == 200;
+        });
+        if (changed && !journal->commit()) return notPersistedResponse();
+        return messageResponse(result.status, result.message);
+    }
+
+    // POST /api/batch [{"op":"add", "name":..., ...}, {"op":"remove", "name":...}, ...]
+    // (ou {"operations":[...]}), com op add, remove, toggle-favorite ou
+    // update. O corpo é lido inteiro antes; depois as operações são
+    // aplicadas em ordem numa só transação (um bloqueio de escrita, uma
+    // versão publicada). Cada uma tem seu resultado, e as que falham não
+    // desfazem as outras.
+    // A versão é publicada antes do commit no log, para que escritores
+    // concorrentes dividam o fsync (group commit). Se o commit falha, as
+    // alterações já estão visíveis, mas não duráveis: a resposta é 500 com
+    // "applied" > 0 e "persisted":false, e como a falha do log é
+    // permanente, as escritas seguintes recebem 503 sem serem aplicadas.
+    HttpResponse handleBatch(const RouteRequest& request) {
+        vector<Operation> operations;
+        JsonReader json(request.body());
+        auto readList = [&] {
+            return json.forEachItem([&] {
+                operations.emplace_back();
+                return readOperation(json, operations.back());
+            });
+        };
+        bool valid = json.peek() == JsonReader::Type::Array ? readList() :
+            json.forEachField([&](string_view key) { return key == "operations" ? readList() : json.skip(); });
+        if (!valid || !json.atEnd()) return messageResponse(400, "JSON invalido");
+        if (journal->hasFailed()) return messageResponse(503, "Gravacao indisponivel");
+
+        vector<OperationResult> results;
+        results.reserve(operations.size());
+        int applied = 0;
+        bool changed = agenda.modify([&](Agenda::Transaction& tx) {
+            for (const Operation& operation : operations) {
+                results.push_back(apply(tx, operation));
+                applied += results.back().status == 200;
+            }
+            return applied > 0;
+        });
+        bool persisted = !changed || journal->commit();
+
+        string body;
+        body.reserve(64 + 48 * results.size());
+        JsonWriter out(body);
+        out.beginObject().key("success").value(persisted).key("persisted").value(persisted).key("applied").value(applied)
+            .key("failed").value((int)results.size() - applied).key("results").beginArray();
+        for (const OperationResult& result : results) {
+            out.beginObject().key("success").value(result.status == 200);
+            if (result.status != 200) out.key("message").value(result.message);
+            out.endObject();
         }
-        WSACleanup();
+        out.endArray();
+        if (!persisted) out.key("message").value("Alteracoes aplicadas, mas nao gravadas em disco");
+        out.endObject();
+        if (!persisted) return "HTTP/1.1 500 Internal Server Error\r\nContent-Type: application/json\r\n\r\n" + body;
+        return jsonResponse(move(body));
     }
 };
 
-int main() {
-    SimpleWebServer server;
+// Uso: agenda_web [porta] [threads] [-q] [-d diretorio] [--sync op|batch|async]
+// Padrão: porta 8080, uma thread por núcleo, dados em "dados", group
+// commit (batch); -q não registra as requisições
+int main(int argc, char** argv) {
+    vector<int> numbers;
+    bool quiet = false;
+    string dataDirectory = "dados";
+    auto durability = ContactJournal::Durability::PerBatch;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-q") quiet = true;
+        else if (arg == "-d" && i + 1 < argc) dataDirectory = argv[++i];
+        else if (arg == "--sync" && i + 1 < argc) {
+            string mode = argv[++i];
+            if (mode == "op") durability = ContactJournal::Durability::PerOperation;
+            else if (mode == "async") durability = ContactJournal::Durability::Async;
+            else if (mode != "batch") {
+                cerr << "Modo de --sync invalido: " << mode << endl;
+                return 1;
+            }
+        }
+        else numbers.push_back(atoi(argv[i]));
+    }
+    int port = numbers.size() > 0 ? numbers[0] : 8080;
+    int threads = numbers.size() > 1 ? numbers[1] : 0;
     
-    if (server.start(8080)) {
-        cout << "Servidor iniciado com sucesso!" << endl;
-        cout << "Acesse: http://localhost:8080" << endl;
-        server.handleRequests();
+    SimpleWebServer app;
+    app.logRequests = !quiet;
+    if (!app.openData(dataDirectory, durability)) {
+        cerr << "Falha ao abrir os dados em " << dataDirectory << endl;
+        return 1;
+    }
+    HttpServer server([&app](const HttpRequest& request) { return app.handleRequest(request); });
+    server.setMaxBodySize(16 << 20); // Lotes grandes em /api/batch
+    
+    if (server.start(port, threads)) {
+        cout << "Servidor rodando na porta " << port << " (" << server.threadCount() << " thread(s))" << endl;
+        cout << "Acesse: http://localhost:" << port << endl;
+        server.run();
     } else {
         cerr << "Falha ao iniciar servidor" << endl;
         return 1;
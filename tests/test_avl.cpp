@@ -1,6 +1,28 @@
 #include <cstdio>
 #include <cassert>
+#include <random>
+#include <map>
+#include <set>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
 #include "../include/avl_tree.h"
+#include "../include/concurrent_avl_tree.h"
+#include "../include/persistent_avl_tree.h"
+#include "../include/collation.h"
+#include "../include/contact_store.h"
+#include "../include/contact_journal.h"
+#include "../include/contact_snapshot.h"
+#include "../include/contact_csv.h"
+#include "../include/bplus_tree.h"
+#include "../include/contact_scan.h"
+#include "../include/fuzzy_index.h"
+#include "../include/http_parser.h"
+#include "../include/http_router.h"
+#include "../include/json_reader.h"
+#include "../include/json_writer.h"
+#include "../include/static_assets.h"
 #include "../include/contact.h"
 
 void runTests() {
@@ -154,13 +176,8 @@ void runTests() {
     assert(inOrder[0].getName() == "A");
     assert(inOrder[6].getName() == "G");
     
-    auto preOrder = tree7.preOrder();
-    assert(preOrder.size() == 7);
-    assert(preOrder[0].getName() == "D"); // Raiz
-    
-    auto postOrder = tree7.postOrder();
-    assert(postOrder.size() == 7);
-    assert(postOrder[6].getName() == "D"); // Raiz por último
+    assert(tree7.rank(Contact("D", "", "")) == 3); // Meio da ordem
+    assert(tree7.rank(Contact("H", "", "")) == 7);
     
     assert(tree7.isBalanced());
     std::cout << "OK!" << std::endl;
@@ -174,6 +191,1259 @@ void runTests() {
     assert(tree8.getFavorites().empty());
     std::cout << "OK!" << std::endl;
     
+    // Teste 9: Tamanho e estatística de ordem
+    std::cout << "Teste 9: Tamanho, rank e select... ";
+    AVLTree<Contact> tree9;
+    assert(tree9.size() == 0);
+    assert(tree9.select(0) == nullptr);
+    
+    for (int i = 0; i < 100; i++) {
+        char name[16];
+        std::snprintf(name, sizeof(name), "C%03d", (i * 37) % 100);
+        tree9.insert(Contact(name, "", ""));
+    }
+    tree9.insert(Contact("C050", "", "")); // Duplicado não altera o tamanho
+    assert(tree9.size() == 100);
+    
+    for (int k = 0; k < 100; k++) {
+        char name[16];
+        std::snprintf(name, sizeof(name), "C%03d", k);
+        const Contact* selected = tree9.select(k);
+        assert(selected != nullptr && selected->getName() == name);
+        assert(tree9.rank(Contact(name, "", "")) == k);
+    }
+    assert(tree9.select(100) == nullptr);
+    assert(tree9.rank(Contact("A", "", "")) == 0);
+    assert(tree9.rank(Contact("C0505", "", "")) == 51);
+    assert(tree9.rank(Contact("Z", "", "")) == 100);
+    
+    for (int i = 0; i < 100; i += 3) {
+        char name[16];
+        std::snprintf(name, sizeof(name), "C%03d", i);
+        tree9.remove(Contact(name, "", ""));
+    }
+    assert(tree9.size() == 66);
+    assert(tree9.select(0)->getName() == "C001");
+    assert(tree9.rank(Contact("C002", "", "")) == 1);
+    assert(tree9.isBalanced());
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 10: Iteradores e visitante
+    std::cout << "Teste 10: Iteradores e forEach... ";
+    AVLTree<Contact> tree10;
+    assert(tree10.begin() == tree10.end());
+    
+    for (int i = 0; i < 64; i++) {
+        char name[16];
+        std::snprintf(name, sizeof(name), "N%02d", (i * 29) % 64);
+        tree10.insert(Contact(name, "", "", i % 4 == 0));
+    }
+    
+    int position = 0;
+    for (const Contact& contact : tree10) {
+        assert(contact.getName() == tree10.select(position)->getName());
+        position++;
+    }
+    assert(position == 64);
+    
+    // Percurso reverso a partir de end()
+    auto it = tree10.end();
+    for (int k = 63; k >= 0; k--) {
+        --it;
+        assert(it->getName() == tree10.select(k)->getName());
+    }
+    assert(it == tree10.begin());
+    
+    int visited = 0;
+    int favoriteCount = 0;
+    tree10.forEach([&](const Contact& contact) {
+        visited++;
+        if (contact.isFavorite()) favoriteCount++;
+    });
+    assert(visited == 64);
+    assert(favoriteCount == (int)tree10.getFavorites().size());
+    
+    assert(tree10.lowerBound(Contact("N10", "", ""))->getName() == "N10");
+    assert(tree10.lowerBound(Contact("N105", "", ""))->getName() == "N11");
+    assert(tree10.lowerBound(Contact("A", "", "")) == tree10.begin());
+    assert(tree10.lowerBound(Contact("Z", "", "")) == tree10.end());
+    
+    auto from = tree10.lowerBound(Contact("N60", "", ""));
+    assert(std::distance(from, tree10.end()) == 4);
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 11: Alocador em pool
+    std::cout << "Teste 11: Alocador em pool... ";
+    AVLTree<Contact, PoolNodeAllocator> tree11;
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 500; i++) {
+            tree11.insert(Contact("P" + std::to_string(i), "123", "p@email.com", i % 2 == 0));
+        }
+        assert(tree11.size() == 500);
+        assert(tree11.isBalanced());
+        for (int i = 0; i < 500; i += 2) {
+            tree11.remove(Contact("P" + std::to_string(i), "", ""));
+        }
+        assert(tree11.size() == 250);
+        assert(tree11.getFavorites().empty());
+    }
+    
+    AVLTree<Contact, PoolNodeAllocator> moved(std::move(tree11));
+    assert(tree11.isEmpty());
+    assert(moved.size() == 250);
+    assert(moved.contains(Contact("P1", "", "")));
+    tree11.insert(Contact("Novo", "", ""));
+    assert(tree11.size() == 1);
+    moved.clear();
+    assert(moved.isEmpty());
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 12: Inserção e remoção iterativas contra std::set
+    std::cout << "Teste 12: Operações aleatórias contra std::set... ";
+    AVLTree<Contact> tree12;
+    std::set<std::string> reference;
+    std::mt19937 rng(12);
+    for (int step = 0; step < 20000; step++) {
+        std::string name = "R" + std::to_string(rng() % 2000);
+        if (rng() % 3 == 0) {
+            bool removed = tree12.remove(Contact(name, "", ""));
+            assert(removed == (reference.erase(name) == 1));
+        } else {
+            bool inserted = tree12.insert(Contact(name, "", ""));
+            assert(inserted == reference.insert(name).second);
+        }
+        if (step % 1000 == 0) assert(tree12.isBalanced());
+    }
+    assert(tree12.isBalanced());
+    assert(tree12.size() == (int)reference.size());
+    auto expected = reference.begin();
+    for (const Contact& contact : tree12) {
+        assert(contact.getName() == *expected++);
+    }
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 13: Carga em massa
+    std::cout << "Teste 13: Carga em massa... ";
+    std::vector<Contact> sorted;
+    for (int i = 0; i < 1000; i++) {
+        char name[16];
+        std::snprintf(name, sizeof(name), "B%04d", i);
+        sorted.emplace_back(name, "", "", i % 10 == 0);
+    }
+    AVLTree<Contact> tree13;
+    tree13.insert(Contact("Antigo", "", ""));
+    tree13.buildFromSorted(sorted.begin(), sorted.end());
+    assert(tree13.size() == 1000);
+    assert(!tree13.contains(Contact("Antigo", "", "")));
+    assert(tree13.isBalanced());
+    assert(tree13.select(500)->getName() == "B0500");
+    assert(tree13.getFavorites().size() == 100);
+    
+    std::vector<Contact> unsorted = {
+        Contact("Zeca", "1", ""), Contact("Ana", "2", ""),
+        Contact("Zeca", "3", ""), Contact("Maria", "4", "")
+    };
+    AVLTree<Contact> tree13b;
+    tree13b.assignBulk(unsorted);
+    assert(tree13b.size() == 3);
+    assert(tree13b.search(Contact("Zeca", "", ""))->getPhone() == "1");
+    assert(tree13b.isBalanced());
+    
+    // Valores já presentes não são substituídos
+    int inserted = tree13b.insertBulk({
+        Contact("Maria", "99", ""), Contact("Bruno", "5", ""),
+        Contact("Zz", "6", ""), Contact("Bruno", "7", "")
+    });
+    assert(inserted == 2);
+    assert(tree13b.size() == 5);
+    assert(tree13b.search(Contact("Maria", "", ""))->getPhone() == "4");
+    assert(tree13b.search(Contact("Bruno", "", ""))->getPhone() == "5");
+    assert(tree13b.select(0)->getName() == "Ana");
+    assert(tree13b.select(4)->getName() == "Zz");
+    assert(tree13b.isBalanced());
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 14: Operações de conjunto com join/split
+    std::cout << "Teste 14: União, diferença, interseção, split e join... ";
+    ForkJoinPool pool(3);
+    std::mt19937 rng14(14);
+    for (int round = 0; round < 4; round++) {
+        int sizeA = round < 2 ? 200 : 20000;
+        int sizeB = round % 2 == 0 ? 150 : 30000;
+        std::set<std::string> setA, setB;
+        AVLTree<Contact> treeA, treeB;
+        for (int i = 0; i < sizeA; i++) {
+            std::string name = "S" + std::to_string(rng14() % 50000);
+            setA.insert(name);
+            treeA.insert(Contact(name, "A", ""));
+        }
+        for (int i = 0; i < sizeB; i++) {
+            std::string name = "S" + std::to_string(rng14() % 50000);
+            setB.insert(name);
+            treeB.insert(Contact(name, "B", ""));
+        }
+        
+        auto matches = [](const AVLTree<Contact>& tree, const std::set<std::string>& expected) {
+            if (tree.size() != (int)expected.size() || !tree.isBalanced()) return false;
+            auto it = expected.begin();
+            for (const Contact& contact : tree) {
+                if (contact.getName() != *it++) return false;
+            }
+            return true;
+        };
+        
+        std::set<std::string> expectedUnion = setA, expectedDiff, expectedInter;
+        expectedUnion.insert(setB.begin(), setB.end());
+        for (const auto& name : setA) {
+            (setB.count(name) ? expectedInter : expectedDiff).insert(name);
+        }
+        
+        AVLTree<Contact> unionTree;
+        unionTree.assignBulk(treeA.inOrder());
+        unionTree.unionWith(treeB, pool);
+        assert(matches(unionTree, expectedUnion));
+        for (const auto& name : setA) {
+            assert(unionTree.search(Contact(name, "", ""))->getPhone() == "A");
+        }
+        
+        AVLTree<Contact> diffTree;
+        diffTree.assignBulk(treeA.inOrder());
+        diffTree.difference(treeB, pool);
+        assert(matches(diffTree, expectedDiff));
+        
+        AVLTree<Contact> interTree;
+        interTree.assignBulk(treeA.inOrder());
+        interTree.intersection(treeB, pool);
+        assert(matches(interTree, expectedInter));
+        
+        AVLTree<Contact, PoolNodeAllocator> pooled;
+        pooled.assignBulk(treeB.inOrder());
+        AVLTree<Contact, PoolNodeAllocator> pooledA;
+        pooledA.assignBulk(treeA.inOrder());
+        pooled.unionWith(std::move(pooledA), pool);
+        assert(pooledA.isEmpty());
+        assert(pooled.size() == (int)expectedUnion.size() && pooled.isBalanced());
+        
+        treeA.unionWith(std::move(treeB), pool);
+        assert(treeB.isEmpty());
+        assert(matches(treeA, expectedUnion));
+    }
+    
+    AVLTree<Contact> whole, less, greater;
+    for (int i = 0; i < 100; i++) {
+        whole.insert(Contact("J" + std::to_string(100 + i), "", ""));
+    }
+    bool splitFound = whole.split(Contact("J150", "", ""), less, greater);
+    assert(splitFound);
+    assert(whole.size() == 1 && less.size() == 50 && greater.size() == 49);
+    assert(less.isBalanced() && greater.isBalanced());
+    
+    AVLTree<Contact> small;
+    small.insert(Contact("A0", "", ""));
+    AVLTree<Contact> joined = AVLTree<Contact>::join(std::move(small), Contact("B", "", ""),
+                                                     AVLTree<Contact>(std::move(greater)));
+    assert(joined.size() == 51 && joined.isBalanced());
+    assert(joined.select(0)->getName() == "A0" && joined.select(1)->getName() == "B");
+    splitFound = joined.split(Contact("J1505", "", ""), less, greater);
+    assert(!splitFound);
+    assert(joined.isEmpty() && less.size() == 2 && greater.size() == 49);
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 15: Árvore concorrente
+    std::cout << "Teste 15: Leituras e escritas concorrentes... ";
+    ConcurrentAVLTree<Contact> shared;
+    for (int i = 0; i < 1000; i++) {
+        shared.insert(Contact("K" + std::to_string(i), "", ""));
+    }
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&shared, t] {
+            for (int i = 0; i < 2000; i++) {
+                std::string name = "K" + std::to_string((i * 7 + t) % 1000);
+                assert(shared.contains(Contact(name, "", "")));
+                // Cada thread só mexe nos seus próprios nomes
+                std::string own = "T" + std::to_string(t) + "_" + std::to_string(i / 2);
+                bool changed = i % 2 == 0 ? shared.insert(Contact(own, "", ""))
+                                          : shared.remove(Contact(own, "", ""));
+                assert(changed);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    assert(shared.size() == 1000);
+    assert(shared.read([](const AVLTree<Contact>& tree) { return tree.isBalanced(); }));
+    assert(shared.find(Contact("K10", "", ""))->getName() == "K10");
+    assert(!shared.find(Contact("T0_0", "", "")));
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 16: Árvore persistente e snapshots
+    std::cout << "Teste 16: Snapshots persistentes... ";
+    PersistentAVLTree<Contact> persistent;
+    for (int i = 0; i < 100; i++) {
+        persistent.insert(Contact("V" + std::to_string(i), "", ""));
+    }
+    auto before = persistent.snapshot();
+    bool duplicateInserted = persistent.insert(Contact("V1", "", ""));
+    assert(!duplicateInserted);
+    assert(persistent.snapshot().sameVersion(before));
+    
+    for (int i = 0; i < 100; i += 2) {
+        persistent.remove(Contact("V" + std::to_string(i), "", ""));
+    }
+    persistent.insert(Contact("Novo", "", ""));
+    
+    // A versão antiga continua inteira e inalterada
+    assert(before.size() == 100 && before.isBalanced());
+    assert(before.contains(Contact("V0", "", "")) && !before.contains(Contact("Novo", "", "")));
+    auto after = persistent.snapshot();
+    assert(after.size() == 51 && after.isBalanced());
+    assert(!after.contains(Contact("V0", "", "")) && after.contains(Contact("Novo", "", "")));
+    
+    std::set<std::string> persistentReference;
+    std::mt19937 rng16(16);
+    PersistentAVLTree<Contact> checked;
+    for (int step = 0; step < 5000; step++) {
+        std::string name = "P" + std::to_string(rng16() % 500);
+        if (rng16() % 3 == 0) {
+            bool removed = checked.remove(Contact(name, "", ""));
+            assert(removed == (persistentReference.erase(name) == 1));
+        } else {
+            bool inserted = checked.insert(Contact(name, "", ""));
+            assert(inserted == persistentReference.insert(name).second);
+        }
+    }
+    auto checkedSnapshot = checked.snapshot();
+    assert(checkedSnapshot.isBalanced() && checkedSnapshot.size() == (int)persistentReference.size());
+    auto expectedName = persistentReference.begin();
+    checkedSnapshot.forEach([&](const Contact& c) { assert(c.getName() == *expectedName++); });
+    
+    // Leitores veem sempre uma versão completa: os pares A/B entram juntos
+    PersistentAVLTree<Contact> paired;
+    std::atomic<bool> done(false);
+    std::thread reader([&] {
+        while (!done) {
+            auto version = paired.snapshot();
+            int count = 0;
+            version.forEach([&](const Contact&) { count++; });
+            assert(count % 2 == 0 && count == version.size());
+        }
+    });
+    for (int i = 0; i < 300; i++) {
+        paired.modify([i](PersistentAVLTree<Contact>::Snapshot& version) {
+            version = version.inserted(Contact("A" + std::to_string(i), "", ""))
+                             .inserted(Contact("B" + std::to_string(i), "", ""));
+            return true;
+        });
+    }
+    done = true;
+    reader.join();
+    assert(paired.size() == 600);
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 17: Colação, prefixos e intervalos
+    std::cout << "Teste 17: Colação, lowerBound/upperBound e range... ";
+    assert(FoldedCollation::compare("ana", "Ana") != 0);
+    assert(FoldedCollation::comparePrimary("ana", "ÁNA") == 0);
+    assert(FoldedCollation::compare("Ágata", "Alberto") < 0);
+    assert(FoldedCollation::compare("Zé", "ana") > 0);
+    assert(FoldedCollation::hasPrefix("Conceição", "conceic"));
+    assert(!FoldedCollation::hasPrefix("Ana", "Anab"));
+    assert(BinaryCollation::compare("Zé", "ana") < 0);
+    
+    using FoldedTree = AVLTree<Contact, HeapNodeAllocator, ContactOrder<FoldedCollation>>;
+    FoldedTree tree17;
+    const char* names[] = {"bia", "Ana", "Álvaro", "ana", "Beatriz", "Carlos", "Zé", "ÉRICA", "Dora"};
+    for (const char* name : names) {
+        tree17.insert(Contact(name, "", ""));
+    }
+    assert(tree17.size() == 9 && tree17.isBalanced());
+    std::vector<std::string> ordered;
+    for (const Contact& c : tree17) ordered.emplace_back(c.getName());
+    std::vector<std::string> expectedOrder = {
+        "Álvaro", "Ana", "ana", "Beatriz", "bia", "Carlos", "Dora", "ÉRICA", "Zé"
+    };
+    assert(ordered == expectedOrder);
+    
+    assert(tree17.lowerBound(Contact("b", "", ""))->getName() == "Beatriz");
+    assert(tree17.upperBound(Contact("bia", "", ""))->getName() == "Carlos");
+    assert(tree17.upperBound(Contact("Zé", "", "")) == tree17.end());
+    
+    std::vector<std::string> inRange;
+    int rangeCount = tree17.range(Contact("b", "", ""), Contact("d", "", ""),
+                               [&](const Contact& c) { inRange.emplace_back(c.getName()); });
+    assert(rangeCount == 3 && inRange[0] == "Beatriz" && inRange[2] == "Carlos");
+    assert(tree17.range(Contact("a", "", ""), Contact("z", "", ""), [](const Contact&) {}, 4) == 4);
+    
+    // Prefixo: a partição pela parte primária encontra "Ana" antes de "ana"
+    auto prefixStart = tree17.partitionPoint([](const Contact& c) {
+        return FoldedCollation::comparePrimary(c.getName(), "an") < 0;
+    });
+    assert(prefixStart->getName() == "Ana");
+    
+    PersistentAVLTree<Contact, ContactOrder<FoldedCollation>> persistent17;
+    for (const char* name : names) {
+        persistent17.insert(Contact(name, "", ""));
+    }
+    auto snapshot17 = persistent17.snapshot();
+    assert(snapshot17.lowerBound(Contact("c", "", ""))->getName() == "Carlos");
+    assert(snapshot17.upperBound(Contact("Zé", "", "")) == nullptr);
+    std::vector<std::string> prefixed;
+    snapshot17.visitFrom(
+        [](const Contact& c) { return FoldedCollation::comparePrimary(c.getName(), "A") < 0; },
+        [&](const Contact& c) {
+            if (!FoldedCollation::hasPrefix(c.getName(), "A")) return false;
+            prefixed.emplace_back(c.getName());
+            return true;
+        });
+    assert(prefixed.size() == 3 && prefixed[0] == "Álvaro");
+    assert(snapshot17.range(Contact("b", "", ""), Contact("d", "", ""), [](const Contact&) {}, 2) == 2);
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 18: Índices secundários por telefone e email
+    std::cout << "Teste 18: ContactStore com índices por telefone e email... ";
+    assert(normalizePhone("(11) 9999-8888") == "1199998888");
+    assert(normalizeEmail("  Ana@Email.COM ") == "ana@email.com");
+    
+    ContactStore<> store18;
+    assert(store18.insert(Contact("Ana", "11-1111-1111", "Ana@Email.com")));
+    assert(store18.insert(Contact("Bruno", "(11) 2222-2222", "bruno@email.com")));
+    assert(store18.insert(Contact("Carla", "11 1111 1111", "")));
+    bool duplicated = store18.insert(Contact("Ana", "99", "outro@email.com"));
+    assert(!duplicated);
+    
+    auto before18 = store18.snapshot();
+    std::vector<Contact> byPhone = before18.findByPhone("1111111111");
+    assert(byPhone.size() == 2 && byPhone[0].getName() == "Ana" && byPhone[1].getName() == "Carla");
+    std::vector<Contact> byEmail = before18.findByEmail("ANA@email.com");
+    assert(byEmail.size() == 1 && byEmail[0].getPhone() == "11-1111-1111");
+    assert(before18.findByEmail("outro@email.com").empty());
+    assert(before18.findByPhone("").empty());
+    
+    // Trocar telefone e email reindexa; a versão anterior continua intacta
+    bool replaced = store18.replace(Contact("Ana", "11-3333-3333", "ana@novo.com"));
+    assert(replaced);
+    auto after18 = store18.snapshot();
+    assert(after18.findByPhone("1111111111").size() == 1);
+    assert(after18.findByPhone("11-3333-3333").size() == 1);
+    assert(after18.findByEmail("ana@email.com").empty());
+    assert(before18.findByEmail("ana@email.com").size() == 1);
+    
+    bool removed18 = store18.remove(Contact("Bruno", "", ""));
+    assert(removed18);
+    auto last18 = store18.snapshot();
+    assert(last18.size() == 2 && last18.isBalanced());
+    assert(last18.findByEmail("bruno@email.com").empty());
+    assert(last18.findByPhone("1122222222").empty());
+    
+    // Várias alterações publicadas como uma única versão
+    bool changed18 = store18.modify([](ContactStore<>::Transaction& tx) {
+        return tx.insert(Contact("Davi", "11-4444-4444", "davi@email.com")) &&
+               tx.remove(Contact("Carla", "", ""));
+    });
+    assert(changed18);
+    auto final18 = store18.snapshot();
+    assert(final18.size() == 2 && final18.findByPhone("1144444444").size() == 1);
+    assert(final18.findByPhone("1111111111").empty());
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 19: Favoritos contados em cada nó (árvore aumentada)
+    std::cout << "Teste 19: Contagem, enumeração e rank/select de favoritos... ";
+    AVLTree<Contact> tree19;
+    std::set<std::string> favorites19;
+    std::mt19937 rng19(19);
+    for (int i = 0; i < 3000; i++) {
+        std::string name = "F" + std::to_string(rng19() % 500);
+        bool favorite = rng19() % 3 == 0;
+        if (rng19() % 4 == 0) {
+            bool wasFavorite = tree19.search(Contact(name, "", "")) &&
+                               tree19.search(Contact(name, "", ""))->isFavorite();
+            if (tree19.remove(Contact(name, "", "")) && wasFavorite) favorites19.erase(name);
+        } else if (tree19.insert(Contact(name, "", "", favorite)) && favorite) {
+            favorites19.insert(name);
+        }
+    }
+    assert(tree19.isBalanced());
+    assert(tree19.markedCount() == (int)favorites19.size());
+    
+    std::vector<std::string> listed19;
+    for (const Contact& c : tree19.getFavorites()) listed19.emplace_back(c.getName());
+    assert(listed19 == std::vector<std::string>(favorites19.begin(), favorites19.end()));
+    
+    int k19 = 0;
+    for (const std::string& name : favorites19) {
+        assert(tree19.selectMarked(k19)->getName() == name);
+        assert(tree19.rankMarked(Contact(name, "", "")) == k19);
+        k19++;
+    }
+    assert(tree19.selectMarked(k19) == nullptr && tree19.selectMarked(-1) == nullptr);
+    
+    // Operações de conjunto e carga em massa preservam as contagens
+    AVLTree<Contact> other19;
+    other19.assignBulk({Contact("F1", "", "", true), Contact("G1", "", "", true), Contact("G2", "", "")});
+    assert(other19.markedCount() == 2 && other19.isBalanced());
+    int before19 = tree19.markedCount() + (tree19.contains(Contact("F1", "", "")) ? 0 : 1);
+    tree19.unionWith(other19);
+    assert(tree19.isBalanced() && tree19.markedCount() == before19 + 1);
+    tree19.intersection(other19);
+    assert(tree19.isBalanced() && tree19.markedCount() == (int)tree19.getFavorites().size());
+    
+    // Sem marcador os nós não contam nada
+    AVLTree<int> ints19;
+    for (int i = 0; i < 100; i++) ints19.insert(i);
+    assert(ints19.markedCount() == 0 && ints19.isBalanced());
+    
+    PersistentAVLTree<Contact> persistent19;
+    persistent19.insert(Contact("A", "", "", true));
+    persistent19.insert(Contact("B", "", ""));
+    auto snapshot19 = persistent19.snapshot();
+    persistent19.insert(Contact("C", "", "", true));
+    assert(snapshot19.markedCount() == 1 && persistent19.snapshot().markedCount() == 2);
+    assert(persistent19.snapshot().isBalanced());
+    
+    ContactStore<> store19;
+    store19.insert(Contact("Ana", "1", "", true));
+    store19.insert(Contact("Bia", "2", ""));
+    store19.modify([](ContactStore<>::Transaction& tx) {
+        return tx.replace(Contact("Bia", "2", "", true));
+    });
+    auto version19 = store19.snapshot();
+    int visited19 = 0;
+    version19.forEachFavorite([&](const Contact&) { visited19++; });
+    assert(version19.favoriteCount() == 2 && visited19 == 2);
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 20: Atualização no próprio nó
+    std::cout << "Teste 20: update e upsert sem remover e reinserir... ";
+    AVLTree<Contact> tree20;
+    for (int i = 0; i < 50; i++) {
+        tree20.insert(Contact("U" + std::to_string(i), "000", "", i % 5 == 0));
+    }
+    const Contact* before20 = tree20.search(Contact("U17", "", ""));
+    bool updated20 = tree20.update(Contact("U17", "", ""), [](ContactDetails& c) {
+        c.setFavorite(true);
+        c.setPhone("11-7777-7777");
+    });
+    assert(updated20);
+    assert(tree20.search(Contact("U17", "", "")) == before20); // Mesmo nó
+    assert(before20->isFavorite() && before20->getPhone() == "11-7777-7777");
+    assert(tree20.markedCount() == 11 && tree20.isBalanced());
+    assert(!tree20.update(Contact("X", "", ""), [](ContactDetails& c) { c.setFavorite(true); }));
+    
+    // O mutador só vê campos que não são a chave
+    static_assert(!std::is_assignable<ContactDetails&, Contact>::value,
+                  "ContactDetails não pode trocar o contato inteiro");
+    
+    bool inserted20 = tree20.upsert(Contact("U0", "123", "u0@email.com", false));
+    assert(!inserted20);
+    assert(tree20.search(Contact("U0", "", ""))->getEmail() == "u0@email.com");
+    assert(tree20.markedCount() == 10 && tree20.size() == 50 && tree20.isBalanced());
+    inserted20 = tree20.upsert(Contact("U99", "", "", true));
+    assert(inserted20 && tree20.markedCount() == 11 && tree20.isBalanced());
+    
+    ContactStore<> store20;
+    store20.insert(Contact("Ana", "11-1111-1111", "ana@email.com"));
+    auto old20 = store20.snapshot();
+    bool storeUpdated = store20.update(Contact("Ana", "", ""), [](ContactDetails& c) {
+        c.setPhone("11-2222-2222");
+        c.setFavorite(true);
+    });
+    assert(storeUpdated);
+    auto new20 = store20.snapshot();
+    assert(new20.findByPhone("1122222222").size() == 1 && new20.findByPhone("1111111111").empty());
+    assert(new20.favoriteCount() == 1 && new20.isBalanced());
+    assert(old20.findByPhone("1111111111").size() == 1 && old20.favoriteCount() == 0);
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 21: Layout compacto do Contact
+    std::cout << "Teste 21: Contact em buffer único... ";
+    static_assert(sizeof(Contact) <= 64, "Contact deve caber em uma linha de cache");
+    Contact short21("Ana", "11-1111-1111", "ana@email.com", true);
+    assert(short21.heapBytes() == 0);
+    assert(short21.getName() == "Ana" && short21.getPhone() == "11-1111-1111" &&
+           short21.getEmail() == "ana@email.com" && short21.isFavorite());
+    
+    std::string longEmail21(80, 'x');
+    Contact long21("Bruno", "11-2222-2222", longEmail21);
+    assert(long21.heapBytes() == 5 + 12 + 80 && long21.getEmail() == longEmail21);
+    
+    Contact copy21(long21);
+    assert(copy21.getEmail() == longEmail21 && copy21.getEmail().data() != long21.getEmail().data());
+    Contact moved21(std::move(copy21));
+    assert(moved21.getName() == "Bruno" && copy21.getName().empty());
+    copy21 = short21;
+    assert(copy21.getEmail() == "ana@email.com");
+    moved21 = std::move(copy21);
+    assert(moved21.getName() == "Ana" && moved21.heapBytes() == 0);
+    
+    // Campos que apontam para o próprio contato e troca entre interno e externo
+    long21.setPhone(long21.getName());
+    assert(long21.getPhone() == "Bruno" && long21.getEmail() == longEmail21);
+    long21.setEmail("b@email.com");
+    assert(long21.heapBytes() == 0 && long21.getName() == "Bruno" && long21.getEmail() == "b@email.com");
+    long21.setEmail(longEmail21);
+    assert(long21.heapBytes() > 0 && long21.getPhone() == "Bruno");
+    
+    bool rejected21 = false;
+    try {
+        Contact huge(std::string(Contact::MaxFieldLength + 1, 'n'));
+    } catch (const std::length_error&) {
+        rejected21 = true;
+    }
+    assert(rejected21);
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 22: Árvore B+ com a interface da AVL
+    std::cout << "Teste 22: Árvore B+ (inserção, remoção, iteração, invariantes)... ";
+    {
+        BPlusTree<int> ints22;
+        std::set<int> reference22;
+        std::mt19937 rng22(22);
+        for (int round = 0; round < 4; round++) {
+            for (int i = 0; i < 30000; i++) {
+                int value = rng22() % 20000;
+                bool inserted = ints22.insert(value);
+                assert(inserted == reference22.insert(value).second);
+            }
+            assert(ints22.isBalanced() && ints22.size() == (int)reference22.size());
+            for (int i = 0; i < 30000; i++) {
+                int value = rng22() % 20000;
+                bool removed = ints22.remove(value);
+                assert(removed == (reference22.erase(value) == 1));
+            }
+            assert(ints22.isBalanced() && ints22.size() == (int)reference22.size());
+        }
+        assert(std::equal(ints22.begin(), ints22.end(), reference22.begin(), reference22.end()));
+        auto last22 = ints22.end();
+        --last22;
+        assert(*last22 == *reference22.rbegin());
+        assert(*ints22.lowerBound(10000) == *reference22.lower_bound(10000));
+        assert(*ints22.upperBound(10000) == *reference22.upper_bound(10000));
+        for (int value : reference22) {
+            bool removed = ints22.remove(value);
+            assert(removed);
+        }
+        assert(ints22.isEmpty() && ints22.isBalanced() && ints22.begin() == ints22.end());
+    }
+    
+    BPlusTree<Contact> contacts22;
+    for (int i = 0; i < 3000; i++) {
+        contacts22.insert(Contact("B" + std::to_string(10000 + i), "", "", i % 4 == 0));
+    }
+    assert(contacts22.height() >= 3 && contacts22.isBalanced());
+    assert(contacts22.markedCount() == 750 && contacts22.getFavorites().size() == 750);
+    assert(contacts22.contains(Contact("B11250", "", "")) && !contacts22.contains(Contact("B20000", "", "")));
+    bool updated22 = contacts22.update(Contact("B10001", "", ""), [](ContactDetails& c) {
+        c.setFavorite(true);
+        c.setEmail("b@email.com");
+    });
+    assert(updated22 && contacts22.markedCount() == 751);
+    assert(contacts22.search(Contact("B10001", "", ""))->getEmail() == "b@email.com");
+    for (int i = 0; i < 3000; i += 2) {
+        contacts22.remove(Contact("B" + std::to_string(10000 + i), "", ""));
+    }
+    assert(contacts22.size() == 1500 && contacts22.isBalanced());
+    assert(contacts22.markedCount() == 1 && contacts22.inOrder().front().getName() == "B10001");
+    int range22 = contacts22.range(Contact("B11000", "", ""), Contact("B12000", "", ""), [](const Contact&) {});
+    assert(range22 == 500);
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 23: Busca por trecho com varredura vetorial
+    std::cout << "Teste 23: Busca por trecho (" << SubstringScan::kernelName() << ")... ";
+    std::mt19937 rng23(23);
+    for (int round = 0; round < 200; round++) {
+        std::string text23(rng23() % 300, 'a');
+        for (char& c : text23) c = "abc"[rng23() % 3];
+        std::string pattern23(1 + rng23() % 5, 'a');
+        for (char& c : pattern23) c = "abc"[rng23() % 3];
+        size_t from23 = rng23() % (text23.size() + 1);
+        size_t expected23 = std::string_view(text23).find(pattern23, from23);
+        assert(SubstringScan::scalar(text23, pattern23, from23) == expected23);
+        assert(SubstringScan::find(text23, pattern23, from23) == expected23);
+#ifdef CONTACT_SCAN_SSE2
+        assert(SubstringScan::sse2(text23, pattern23, from23) == expected23);
+#endif
+#ifdef CONTACT_SCAN_AVX2
+        assert(SubstringScan::avx2(text23, pattern23, from23) == expected23);
+#endif
+    }
+    
+    ContactStore<ContactOrder<FoldedCollation>> store23;
+    store23.insert(Contact("José Conceição", "11-1234-5678", "jose@empresa.com"));
+    store23.insert(Contact("Ana Paula", "21-9999-0000", "ana@conceicao.org"));
+    store23.insert(Contact("Bruno", "31-5678-1111", "bruno@email.com"));
+    auto version23 = store23.snapshot();
+    ContactScanIndex index23(version23);
+    std::vector<std::string> found23;
+    int count23 = index23.search("CONCEICAO", [&](const Contact& c) { found23.emplace_back(c.getName()); });
+    assert(count23 == 2 && found23[0] == "Ana Paula" && found23[1] == "José Conceição");
+    assert(index23.search("5678", [](const Contact&) {}) == 2);
+    assert(index23.search("5678", [](const Contact&) {}, 1) == 1);
+    assert(index23.search("empresa.com", [](const Contact&) {}) == 1);
+    assert(index23.search("xyz", [](const Contact&) {}) == 0);
+    assert(version23.sameVersion(store23.snapshot()));
+    store23.insert(Contact("Carla", "", ""));
+    assert(!version23.sameVersion(store23.snapshot()));
+    
+    // Comparação em blocos continua igual à comparação caractere a caractere
+    assert(FoldedCollation::comparePrimary("Maria Aparecida Ágata", "MARIA APARECIDA AGATA") == 0);
+    assert(FoldedCollation::comparePrimary("Maria Aparecida Souza", "Maria Aparecida Silva") > 0);
+    assert(FoldedCollation::comparePrimary("Maria Aparecida", "Maria Aparecida Silva") < 0);
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 24: Busca tolerante a erros de digitação
+    std::cout << "Teste 24: Busca aproximada por trigramas... ";
+    assert(FuzzyIndex::distance("beatris santo", "beatriz santos", 2) == 1);
+    assert(FuzzyIndex::distance("baetriz", "ana beatriz", 2) == 1); // Transposição
+    assert(FuzzyIndex::distance("xyzw", "beatriz", 2) == 3);
+    
+    ContactStore<ContactOrder<FoldedCollation>> store24;
+    FuzzyIndex fuzzy24;
+    store24.setChangeListener([&](const Contact* before, const Contact* after) {
+        if (after) {
+            fuzzy24.set(after->getName(), after->getEmail());
+        } else {
+            fuzzy24.remove(before->getName());
+        }
+    });
+    store24.insert(Contact("Beatriz Santos", "", "bia@email.com"));
+    store24.insert(Contact("Beatriz Souza", "", "souza@email.com"));
+    store24.insert(Contact("Carlos Conceição", "", "carlos@email.com"));
+    for (int i = 0; i < 200; i++) {
+        store24.insert(Contact("Contato " + std::to_string(i), "", ""));
+    }
+    assert(fuzzy24.size() == 203);
+    
+    std::vector<std::pair<std::string, int>> found24;
+    auto collect24 = [&](std::string_view name, int distance) { found24.emplace_back(name, distance); };
+    fuzzy24.search("Beatris Santo", 10, collect24);
+    assert(!found24.empty() && found24[0].first == "Beatriz Santos" && found24[0].second == 1);
+    found24.clear();
+    fuzzy24.search("CONCEICAO", 10, collect24);
+    assert(found24.size() == 1 && found24[0].second == 0);
+    found24.clear();
+    assert(fuzzy24.search("Contato 1", 3, collect24) == 3 && found24[0].second == 0);
+    
+    // Email alterado é reindexado; removidos somem e o índice é compactado
+    store24.update(Contact("Beatriz Souza", "", ""), [](ContactDetails& c) { c.setEmail("bsouza@empresa.com"); });
+    found24.clear();
+    fuzzy24.search("empressa", 10, collect24);
+    assert(found24.size() == 1 && found24[0].first == "Beatriz Souza");
+    for (int i = 0; i < 200; i++) {
+        store24.remove(Contact("Contato " + std::to_string(i), "", ""));
+    }
+    assert(fuzzy24.size() == 3 && fuzzy24.search("Contato 1", 3, collect24) == 0);
+    assert(fuzzy24.search("ab", 10, collect24) == 0); // Sem trigramas
+    // Trocas repetidas de email também compactam (entradas antigas descartadas)
+    for (int i = 0; i < 500; i++) fuzzy24.set("Beatriz Souza", "souza" + std::to_string(i) + "@troca.com");
+    found24.clear();
+    assert(fuzzy24.size() == 3 && fuzzy24.search("souza499@troca", 10, collect24) == 1);
+    assert(found24[0].first == "Beatriz Souza" && fuzzy24.search("Beatris Santo", 10, collect24) >= 1);
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 25: Parser HTTP incremental
+    std::cout << "Teste 25: Parser HTTP (pedaços, chunked, pipelining)... ";
+    std::string stream25 =
+        "GET /api/statistics HTTP/1.1\r\nHost: x\r\n\r\n"
+        "POST /api/add HTTP/1.1\r\nHost: x\r\nTransfer-Encoding: chunked\r\n\r\n"
+        "5\r\n{\"a\":\r\n3;ext=1\r\n\"b\"\r\n1\r\n}\r\n0\r\nTrailer: t\r\n\r\n"
+        "POST /api/remove HTTP/1.0\r\ncontent-length: 4\r\nConnection: keep-alive\r\n\r\nabcd"
+        "GET / HTTP/1.1\r\nConnection: close\r\n\r\n";
+    HttpRequestParser parser25;
+    std::vector<HttpRequest> requests25;
+    HttpRequest request25;
+    for (char c : stream25) { // Um byte por vez: o pior caso de leituras parciais
+        parser25.append(&c, 1);
+        while (parser25.next(request25) == HttpRequestParser::Status::Complete) {
+            requests25.push_back(request25);
+        }
+    }
+    assert(requests25.size() == 4 && parser25.pending() == 0);
+    assert(requests25[0].method == "GET" && requests25[0].target == "/api/statistics");
+    assert(requests25[0].keepAlive() && requests25[0].body.empty());
+    assert(requests25[1].method == "POST" && requests25[1].target == "/api/add");
+    assert(*requests25[1].header("host") == "x" && *requests25[1].header("Transfer-Encoding") == "chunked");
+    assert(requests25[1].body == "{\"a\":\"b\"}");
+    assert(requests25[2].body == "abcd" && requests25[2].keepAlive());
+    assert(*requests25[2].header("Content-Length") == "4");
+    assert(requests25[3].target == "/" && !requests25[3].keepAlive());
+    
+    HttpRequestParser large25(16);
+    std::string tooLarge25 = "POST / HTTP/1.1\r\nContent-Length: 17\r\n\r\n";
+    large25.append(tooLarge25.data(), tooLarge25.size());
+    assert(large25.next(request25) == HttpRequestParser::Status::Error && large25.errorStatus() == 413);
+    HttpRequestParser bad25;
+    std::string garbage25 = "GARBAGE\r\n\r\n";
+    bad25.append(garbage25.data(), garbage25.size());
+    assert(bad25.next(request25) == HttpRequestParser::Status::Error && bad25.errorStatus() == 400);
+    HttpRequestParser expect25;
+    std::string continue25 = "POST / HTTP/1.1\r\nExpect: 100-continue\r\nContent-Length: 2\r\n\r\n";
+    expect25.append(continue25.data(), continue25.size());
+    assert(expect25.next(request25) == HttpRequestParser::Status::NeedMore);
+    assert(expect25.takeContinueRequest() && !expect25.takeContinueRequest());
+    
+    std::string response25 = finalizeResponse("HTTP/1.1 404 Not Found\r\nConnection: close\r\n\r\nnada", true);
+    assert(response25 == "HTTP/1.1 404 Not Found\r\nContent-Length: 4\r\nConnection: keep-alive\r\n\r\nnada");
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 26: Roteador por trie de segmentos
+    std::cout << "Teste 26: Roteador (trie, parâmetros, 404/405)... ";
+    HttpRouter router26;
+    router26.add("GET", "/", [](const RouteRequest&) { return std::string("raiz"); });
+    router26.add("GET", "/api/contacts", [](const RouteRequest&) { return std::string("lista"); });
+    router26.add("GET", "/api/contacts/:name", [](const RouteRequest& r) { return "um:" + r.param("name"); });
+    router26.add("GET", "/api/contacts/favorites", [](const RouteRequest&) { return std::string("favoritos"); });
+    router26.add("POST", "/api/contacts", [](const RouteRequest& r) { return "novo:" + r.body(); });
+    router26.add("GET", "/api/search", [](const RouteRequest& r) {
+        return r.query("q") + "|" + r.query("limit") + "|" + r.query("nada");
+    });
+    auto route26 = [&](const std::string& method, const std::string& target, const std::string& body = "") {
+        HttpRequest request;
+        request.method = method;
+        request.target = target;
+        request.version = "HTTP/1.1";
+        request.body = body;
+        return router26.dispatch(request).text;
+    };
+    assert(route26("GET", "/") == "raiz");
+    assert(route26("GET", "/api/contacts") == "lista");
+    assert(route26("GET", "/api/contacts?x=1") == "lista");
+    assert(route26("GET", "/api/contacts/Ana%20Silva") == "um:Ana Silva");
+    assert(route26("GET", "/api/contacts/a+b") == "um:a+b"); // '+' só é espaço na query
+    assert(route26("GET", "/api/contacts/favorites") == "favoritos"); // Fixo antes de :name
+    assert(route26("POST", "/api/contacts", "{}") == "novo:{}");
+    assert(route26("GET", "/api/search?q=Jo%C3%A3o+S&limit=5&q=outro") == "João S|5|");
+    assert(route26("GET", "/api/search?semvalor&q=") == "||");
+    assert(route26("GET", "/api/contactsX").compare(0, 12, "HTTP/1.1 404") == 0);
+    assert(route26("GET", "/api/contacts/").compare(0, 12, "HTTP/1.1 404") == 0);
+    assert(route26("GET", "/api/contacts/a/b").compare(0, 12, "HTTP/1.1 404") == 0);
+    assert(route26("GET", "*").compare(0, 12, "HTTP/1.1 404") == 0);
+    std::string notAllowed26 = route26("DELETE", "/api/contacts");
+    assert(notAllowed26.compare(0, 12, "HTTP/1.1 405") == 0 && notAllowed26.find("Allow: GET, POST\r\n") != std::string::npos);
+    // A rota vem da linha de requisição, não do corpo
+    assert(route26("POST", "/x", "GET /api/contacts HTTP/1.1").compare(0, 12, "HTTP/1.1 404") == 0);
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 27: Arquivos estáticos em cache (gzip, ETag, 304)
+    std::cout << "Teste 27: Arquivos estáticos (gzip, ETag, 304)... ";
+    assert(Gzip::crc32("123456789") == 0xCBF43926u);
+    std::string text27;
+    for (int i = 0; i < 200; i++) text27 += "body { color: #" + std::to_string(i % 7) + "; }\n";
+    std::string gzip27 = Gzip::compress(text27);
+    assert(gzip27.compare(0, 3, "\x1f\x8b\x08") == 0 && gzip27.size() * 10 < text27.size());
+    auto trailer27 = [&](std::size_t at) {
+        std::uint32_t value = 0;
+        for (int i = 3; i >= 0; i--) value = (value << 8) | (unsigned char)gzip27[at + i];
+        return value;
+    };
+    assert(trailer27(gzip27.size() - 8) == Gzip::crc32(text27) && trailer27(gzip27.size() - 4) == text27.size());
+    
+    std::string file27 = (std::filesystem::temp_directory_path() / "agenda_teste27.css").string();
+    std::ofstream(file27, std::ios::binary) << text27;
+    StaticAssets assets27(std::chrono::milliseconds(0));
+    HttpRequest request27;
+    request27.method = "GET";
+    request27.version = "HTTP/1.1";
+    HttpResponse plain27 = assets27.serve(file27, request27);
+    assert(plain27.body && *plain27.body == text27 && plain27.text.find("Content-Type: text/css\r\n") != std::string::npos);
+    assert(plain27.text.find("Content-Encoding") == std::string::npos);
+    request27.headers.push_back({"Accept-Encoding", "deflate, gzip;q=0.5"});
+    HttpResponse gzipped27 = assets27.serve(file27, request27);
+    assert(gzipped27.body && *gzipped27.body == gzip27);
+    assert(gzipped27.text.find("Content-Encoding: gzip\r\n") != std::string::npos);
+    std::size_t tagStart27 = gzipped27.text.find("ETag: ") + 6;
+    std::string etag27 = gzipped27.text.substr(tagStart27, gzipped27.text.find("\r\n", tagStart27) - tagStart27);
+    request27.headers.push_back({"If-None-Match", "\"outra\", W/" + etag27});
+    HttpResponse notModified27 = assets27.serve(file27, request27);
+    assert(notModified27.text.compare(0, 12, "HTTP/1.1 304") == 0 && !notModified27.body);
+    finalizeResponse(notModified27, true);
+    assert(notModified27.text.find("Content-Length") == std::string::npos);
+    finalizeResponse(gzipped27, false);
+    assert(gzipped27.text.find("Content-Length: " + std::to_string(gzip27.size()) + "\r\n") != std::string::npos);
+    assert(gzipped27.text.find("Connection: close\r\n\r\n") == gzipped27.text.size() - 21);
+    request27.headers[0].second = "gzip;q=0";
+    assert(StaticAssets::acceptQuality("gzip;q=0, *", "gzip") == 0 && StaticAssets::acceptQuality("*", "br") == 1);
+    // Arquivo alterado: nova ETag, a antiga não vale mais
+    std::ofstream(file27, std::ios::binary | std::ios::app) << "/* fim */";
+    std::filesystem::last_write_time(file27, std::filesystem::last_write_time(file27) + std::chrono::seconds(2));
+    HttpResponse changed27 = assets27.serve(file27, request27);
+    assert(changed27.text.compare(0, 12, "HTTP/1.1 200") == 0 && *changed27.body == text27 + "/* fim */");
+    std::filesystem::remove(file27);
+    assert(assets27.serve(file27, request27).text.compare(0, 12, "HTTP/1.1 404") == 0);
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 28: JSON direto no buffer e páginas da árvore persistente
+    std::cout << "Teste 28: JsonWriter e paginação (rank, cursor)... ";
+    std::string json28;
+    JsonWriter writer28(json28);
+    writer28.beginObject().key("a\"b").value("x\\y\n\x01").key("list").beginArray()
+        .value(1).value(-2).value(true).null().beginObject().endObject().endArray()
+        .key("ok").value(false).endObject();
+    assert(json28 == "{\"a\\\"b\":\"x\\\\y\\n\\u0001\",\"list\":[1,-2,true,null,{}],\"ok\":false}");
+    
+    PersistentAVLTree<int> pages28;
+    for (int i = 0; i < 500; i++) pages28.insert(i * 2);
+    auto version28 = pages28.snapshot();
+    std::vector<int> page28;
+    auto take28 = [&](int limit) {
+        page28.clear();
+        return [&page28, limit](int x) {
+            if ((int)page28.size() == limit) return false;
+            page28.push_back(x);
+            return true;
+        };
+    };
+    for (int k : {0, 1, 250, 499}) {
+        version28.visitFromRank(k, take28(3));
+        assert(page28[0] == 2 * k && (int)page28.size() == std::min(3, 500 - k));
+        if (page28.size() > 1) assert(page28[1] == 2 * k + 2);
+    }
+    version28.visitFromRank(500, take28(3));
+    assert(page28.empty());
+    version28.visitAfter(101, take28(2)); // Cursor que não está na árvore
+    assert(page28 == std::vector<int>({102, 104}));
+    version28.visitAfter(102, take28(2));
+    assert(page28 == std::vector<int>({104, 106}));
+    // Percorrer por cursor visita todos uma vez
+    int cursor28 = -1, seen28 = 0;
+    while (true) {
+        version28.visitAfter(cursor28, take28(64));
+        if (page28.empty()) break;
+        assert(page28[0] == (cursor28 < 0 ? 0 : cursor28 + 2));
+        seen28 += (int)page28.size();
+        cursor28 = page28.back();
+    }
+    assert(seen28 == 500 && cursor28 == 998);
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 29: leitura de JSON sob demanda, com espaços, escapes e campos ignorados
+    std::cout << "Teste 29: JsonReader (escapes, skip, erros)... ";
+    std::string body29 = " {\n \"name\" : \"Jo\\u00e3o \\\"J\\\"\\ud83d\\ude00\",\t\"extra\": [1, -2.5e3, {\"a\": [null, true]}, \"x\"],"
+                         "\"favorite\":false, \"age\": 42 } ";
+    std::string name29;
+    bool favorite29 = true;
+    double age29 = 0;
+    JsonReader reader29(body29);
+    assert(reader29.peek() == JsonReader::Type::Object);
+    bool valid29 = reader29.forEachField([&](std::string_view key) {
+        if (key == "name") return reader29.readString(name29);
+        if (key == "favorite") return reader29.readBool(favorite29);
+        if (key == "age") return reader29.readNumber(age29);
+        return reader29.skip();
+    });
+    assert(valid29 && reader29.atEnd());
+    assert(name29 == "Jo\xc3\xa3o \"J\"\xf0\x9f\x98\x80");
+    assert(!favorite29 && age29 == 42);
+    // Lista de objetos
+    JsonReader list29("[{\"op\":\"add\"}, {\"op\":\"remove\"}]");
+    std::vector<std::string> ops29;
+    assert(list29.forEachItem([&] {
+        return list29.forEachField([&](std::string_view) {
+            ops29.emplace_back();
+            return list29.readString(ops29.back());
+        });
+    }) && list29.atEnd());
+    assert(ops29 == std::vector<std::string>({"add", "remove"}));
+    // Entradas inválidas
+    auto invalid29 = [](const std::string& text) {
+        JsonReader reader(text);
+        return !(reader.skip() && reader.atEnd());
+    };
+    assert(invalid29("{\"a\":1,}"));
+    assert(invalid29("[1 2]"));
+    assert(invalid29("\"sem fim"));
+    assert(invalid29("\"a\\x\""));
+    assert(invalid29("\"\\ud83d\""));
+    assert(invalid29("01"));
+    assert(invalid29("1."));
+    assert(invalid29("tru"));
+    assert(invalid29("{\"a\":1} x"));
+    assert(invalid29(""));
+    assert(invalid29(std::string(65, '[') + std::string(65, ']')));
+    assert(!invalid29(std::string(64, '[') + std::string(64, ']')));
+    // Erro dentro de forEachField interrompe as leituras seguintes
+    JsonReader broken29("{\"a\": tru}");
+    std::string ignored29;
+    assert(!broken29.forEachField([&](std::string_view) { return broken29.skip(); }));
+    assert(!broken29.ok() && !broken29.readString(ignored29));
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 30: log de escrita antecipada, queda no meio de um registro e checkpoint
+    std::cout << "Teste 30: Log e snapshot da agenda (recuperacao)... ";
+    std::string dir30 = (std::filesystem::temp_directory_path() / "agenda_journal_test30").string();
+    std::filesystem::remove_all(dir30);
+    std::map<std::string, Contact> agenda30;
+    auto recover30 = [&](ContactJournal& journal) {
+        agenda30.clear();
+        return journal.recover(
+            [&](const Contact& contact) { agenda30[std::string(contact.getName())] = contact; },
+            [&](std::string_view name) { agenda30.erase(std::string(name)); });
+    };
+    {
+        ContactJournal journal30(dir30, ContactJournal::Durability::PerOperation);
+        assert(recover30(journal30) && journal30.isNew() && journal30.open());
+        journal30.logPut(Contact("Ana", "1", "ana@x.com", true));
+        journal30.logPut(Contact("Bia", "2"));
+        journal30.logRemove("Ana");
+        journal30.logPut(Contact("Bia", "22", "bia@x.com"));
+        assert(journal30.commit());
+    }
+    {
+        // Vários escritores dividindo os fsyncs
+        ContactJournal journal30(dir30, ContactJournal::Durability::PerBatch);
+        assert(recover30(journal30) && !journal30.isNew() && journal30.open());
+        assert(agenda30.size() == 1 && agenda30["Bia"].getPhone() == "22");
+        std::vector<std::thread> writers30;
+        for (int t = 0; t < 4; t++) {
+            writers30.emplace_back([&, t] {
+                for (int i = 0; i < 50; i++) {
+                    journal30.logPut(Contact("W" + std::to_string(t) + "_" + std::to_string(i)));
+                    assert(journal30.commit());
+                }
+            });
+        }
+        for (auto& writer : writers30) writer.join();
+    }
+    // Registro pela metade no fim do log: é ignorado e descartado
+    std::string wal30 = dir30 + "/agenda.wal";
+    auto walSize30 = std::filesystem::file_size(wal30);
+    std::ofstream(wal30, std::ios::binary | std::ios::app) << std::string("\x20\0\0\0garbage", 11);
+    {
+        ContactJournal journal30(dir30, ContactJournal::Durability::Async);
+        assert(recover30(journal30) && journal30.open());
+        assert(agenda30.size() == 201 && std::filesystem::file_size(wal30) == walSize30);
+        journal30.logRemove("W0_0");
+        // Async: gravado ao fechar
+    }
+    {
+        ContactJournal journal30(dir30);
+        assert(recover30(journal30) && journal30.open());
+        assert(agenda30.size() == 200 && !agenda30.count("W0_0"));
+        // Checkpoint: snapshot com a agenda e log vazio
+        assert(journal30.logSize() > 0);
+        assert(journal30.checkpoint([&](ContactSnapshot::Writer& writer) {
+            for (const auto& entry : agenda30) writer.add(entry.second);
+        }));
+        assert(journal30.logSize() == 0 && std::filesystem::file_size(wal30) == 0);
+        assert(!std::filesystem::exists(dir30 + "/agenda.wal.old"));
+        journal30.logPut(Contact("Caio", "3"));
+        assert(journal30.commit());
+    }
+    {
+        ContactJournal journal30(dir30);
+        assert(recover30(journal30) && agenda30.size() == 201);
+        assert(agenda30["Bia"].getEmail() == "bia@x.com" && agenda30.count("Caio"));
+    }
+    // Snapshot corrompido: recover falha em vez de começar vazio
+    {
+        std::fstream snapshot30(dir30 + "/agenda.snapshot", std::ios::binary | std::ios::in | std::ios::out);
+        snapshot30.seekp(40);
+        snapshot30.put('#');
+    }
+    {
+        ContactJournal journal30(dir30);
+        assert(!recover30(journal30));
+    }
+    std::filesystem::remove_all(dir30);
+    // Checkpoint automático lento: os commits PerBatch seguem sem esperá-lo
+    std::atomic<bool> entered30{false}, released30{false};
+    {
+        ContactJournal journal30(dir30, ContactJournal::Durability::PerBatch);
+        assert(recover30(journal30) && journal30.open());
+        journal30.setCheckpointSource([&](ContactSnapshot::Writer& writer) {
+            entered30 = true;
+            auto limit30 = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (!released30 && std::chrono::steady_clock::now() < limit30) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            writer.add(Contact("Ana"));
+        }, 1);
+        journal30.logPut(Contact("Ana"));
+        assert(journal30.commit());
+        while (!entered30) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        auto start30 = std::chrono::steady_clock::now();
+        journal30.logPut(Contact("Bia"));
+        assert(journal30.commit());
+        assert(std::chrono::steady_clock::now() - start30 < std::chrono::seconds(2) && !released30);
+        released30 = true;
+    }
+    {
+        ContactJournal journal30(dir30);
+        assert(recover30(journal30) && agenda30.size() == 2 && agenda30.count("Bia"));
+    }
+    std::filesystem::remove_all(dir30);
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 31: snapshot binário mapeado e montagem das árvores em O(n)
+    std::cout << "Teste 31: Snapshot binario (mmap, checksum, fromSorted)... ";
+    std::vector<Contact> sorted31;
+    for (int i = 0; i < 1000; i++) {
+        char name31[16];
+        std::snprintf(name31, sizeof(name31), "C%04d", i);
+        // Alguns com campos longos (fora do objeto) ou vazios
+        std::string email31 = i % 7 == 0 ? std::string(80, 'e') + "@x.com" : i % 3 == 0 ? "" : "c" + std::to_string(i) + "@x.com";
+        sorted31.emplace_back(name31, i % 2 ? "11-" + std::to_string(i % 50) : "", email31, i % 5 == 0);
+    }
+    std::string path31 = (std::filesystem::temp_directory_path() / "agenda_snapshot_test31").string();
+    // write(writer) preenche o snapshot; o cabeçalho entra por último
+    auto save31 = [&](const std::function<void(ContactSnapshot::Writer&)>& write) {
+        std::string image;
+        ContactSnapshot::Writer writer([&](std::string_view data) { image.append(data); return true; });
+        write(writer);
+        assert(writer.finish());
+        image.replace(0, ContactSnapshot::HeaderSize, writer.header());
+        std::ofstream(path31, std::ios::binary | std::ios::trunc) << image;
+        return image;
+    };
+    auto write31 = [&](const std::vector<Contact>& contacts) {
+        return save31([&](ContactSnapshot::Writer& writer) {
+            for (const Contact& contact : contacts) writer.add(contact);
+        });
+    };
+    std::string image31 = write31(sorted31);
+    {
+        ContactSnapshot snapshot31;
+        assert(snapshot31.open(path31) && snapshot31.size() == 1000);
+        for (std::size_t i = 0; i < sorted31.size(); i++) {
+            ContactSnapshot::Entry entry = snapshot31[i];
+            assert(entry.name == sorted31[i].getName() && entry.phone == sorted31[i].getPhone());
+            assert(entry.email == sorted31[i].getEmail() && entry.favorite == sorted31[i].isFavorite());
+        }
+    }
+    // Um byte trocado nos textos, arquivo cortado e versão desconhecida
+    for (std::size_t offset31 : {ContactSnapshot::HeaderSize + 3, image31.size(), std::size_t(8)}) {
+        std::string broken31 = image31;
+        if (offset31 == image31.size()) broken31.pop_back();
+        else broken31[offset31] ^= 1;
+        std::ofstream(path31, std::ios::binary | std::ios::trunc) << broken31;
+        ContactSnapshot snapshot31;
+        assert(!snapshot31.open(path31));
+    }
+    // Tamanhos forjados com o checksum refeito: recusados sem estourar as contas
+    auto forge31 = [&](std::size_t offset, std::uint64_t value) {
+        std::string forged31 = image31;
+        for (int i = 0; i < 8; i++) forged31[offset + i] = (char)(value >> (8 * i));
+        SnapshotChecksum checksum31;
+        checksum31.update(std::string_view(forged31).substr(ContactSnapshot::HeaderSize));
+        for (int i = 0; i < 8; i++) forged31[56 + i] = (char)(checksum31.value() >> (8 * i));
+        std::ofstream(path31, std::ios::binary | std::ios::trunc) << forged31;
+        ContactSnapshot snapshot31;
+        return snapshot31.open(path31);
+    };
+    assert(forge31(16, 1000));                                  // sem mudança: válido
+    assert(!forge31(24, ~std::uint64_t(0) - 6));                // textos: recordsOffset daria a volta
+    assert(!forge31(16, std::uint64_t(1) << 60));               // registros * 16 daria a volta
+    assert(!forge31(image31.size() - 1000 * ContactSnapshot::RecordSize, ~std::uint64_t(0) - 10)); // texto fora do arquivo
+    write31({});
+    {
+        ContactSnapshot empty31;
+        assert(empty31.open(path31) && empty31.size() == 0);
+    }
+    // Árvore persistente montada de baixo para cima: balanceada e em ordem
+    for (int n = 0; n <= 70; n++) {
+        int next31 = 0;
+        auto tree31 = PersistentAVLTree<int>::Snapshot::fromSorted(n, [&] { return 2 * next31++; });
+        assert(tree31.size() == n && tree31.isBalanced());
+        std::vector<int> values31;
+        tree31.forEach([&](int value) { values31.push_back(value); });
+        for (int i = 0; i < n; i++) assert(values31[i] == 2 * i);
+        assert(n == 0 || (tree31.contains(2 * (n - 1)) && !tree31.contains(1)));
+        for (int i = 0; i <= 2 * n; i++) assert(tree31.rank(i) == (i + 1) / 2);
+    }
+    // Agenda inteira a partir do snapshot, com índices por telefone e email
+    write31(sorted31);
+    ContactSnapshot snapshot31;
+    assert(snapshot31.open(path31));
+    ContactStore<> store31;
+    std::size_t next31 = 0;
+    assert(store31.assignSorted((int)snapshot31.size(), [&] { return snapshot31[next31++].toContact(); }));
+    ContactStore<>::Snapshot version31 = store31.snapshot();
+    assert(version31.size() == 1000 && version31.isBalanced());
+    assert(version31.favoriteCount() == 200);
+    assert(version31.findByPhone("11 7").size() == 20); // i % 50 == 7
+    assert(version31.findByEmail("C14@X.com").empty() && version31.findByEmail("c13@x.com").size() == 1);
+    store31.insert(Contact("C0000a"));
+    assert(store31.snapshot().size() == 1001 && store31.snapshot().isBalanced());
+    // Fora de ordem: nada muda
+    std::vector<Contact> unsorted31 = {Contact("B"), Contact("A")};
+    next31 = 0;
+    assert(!store31.assignSorted(2, [&] { return unsorted31[next31++]; }));
+    assert(store31.snapshot().size() == 1001);
+    // Snapshot com a ordem dos índices: mesmas consultas sem ordenar
+    ContactStore<> agenda31;
+    for (int i = 0; i < 300; i++) {
+        agenda31.insert(Contact("N" + std::to_string(i), "9" + std::to_string(i % 40), i % 4 ? "M" + std::to_string(i % 9) : ""));
+    }
+    save31([&](ContactSnapshot::Writer& writer) { agenda31.snapshot().writeTo(writer); });
+    ContactSnapshot ordered31;
+    assert(ordered31.open(path31) && ordered31.phoneOrderSize() == 300 && ordered31.emailOrderSize() == 225);
+    ContactStore<> loaded31;
+    assert(loaded31.assign(ordered31) && loaded31.snapshot().isBalanced());
+    for (int key = 0; key < 40; key++) {
+        assert(loaded31.snapshot().findByPhone("9" + std::to_string(key)).size() == agenda31.snapshot().findByPhone("9" + std::to_string(key)).size());
+    }
+    assert(loaded31.snapshot().findByEmail("m4").size() == agenda31.snapshot().findByEmail("m4").size());
+    // Ordem gravada que não confere: o índice é refeito e ordenado
+    save31([&](ContactSnapshot::Writer& writer) {
+        agenda31.snapshot().forEach([&](const Contact& contact) { writer.add(contact); });
+        for (int i = 0; i < 300; i++) writer.addPhoneOrder(299 - i);
+    });
+    assert(ordered31.open(path31) && loaded31.assign(ordered31));
+    assert(loaded31.snapshot().findByPhone("97").size() == 8);
+    assert(loaded31.snapshot().findByEmail("M4").size() == agenda31.snapshot().findByEmail("m4").size());
+    std::filesystem::remove(path31);
+    std::cout << "OK!" << std::endl;
+    
+    // Teste 32: CSV com aspas (RFC 4180), blocos pequenos e erros
+    std::cout << "Teste 32: CSV (aspas, CRLF, blocos, erros)... ";
+    std::string path32 = (std::filesystem::temp_directory_path() / "agenda_csv_test32.csv").string();
+    auto read32 = [&](const std::string& text, std::size_t blockSize, std::vector<std::vector<std::string>>& rows) {
+        std::ofstream(path32, std::ios::binary | std::ios::trunc) << text;
+        CsvReader reader32(path32, blockSize);
+        std::vector<std::string_view> fields32;
+        rows.clear();
+        while (reader32.next(fields32)) rows.emplace_back(fields32.begin(), fields32.end());
+        return reader32.ok();
+    };
+    std::string text32 = "\xEF\xBB\xBFNome,Telefone\r\n"
+                         "\"Silva, Ana\",\"11 \"\"casa\"\"\"\r\n"
+                         "\n"
+                         "\"linha\nquebrada\",,x\n"
+                         "\"\"\"\",fim";
+    std::vector<std::vector<std::string>> expected32 = {
+        {"Nome", "Telefone"}, {"Silva, Ana", "11 \"casa\""}, {"linha\nquebrada", "", "x"}, {"\"", "fim"}};
+    // Todos os tamanhos de bloco: registros cortados em qualquer ponto
+    for (std::size_t block32 = 1; block32 <= text32.size() + 1; block32++) {
+        std::vector<std::vector<std::string>> rows32;
+        assert(read32(text32, block32, rows32) && rows32 == expected32);
+    }
+    std::vector<std::vector<std::string>> rows32;
+    assert(!read32("a,\"b\n", 4, rows32) && rows32.empty());         // aspas sem fechar
+    assert(!read32("a\n\"b\"c,d\n", 64, rows32) && rows32.size() == 1); // texto depois das aspas
+    assert(read32("", 64, rows32) && rows32.empty());
+    // Exportação e importação de contatos com campos especiais
+    ContactStore<> store32;
+    for (int i = 0; i < 2000; i++) {
+        std::string name32 = "Contato " + std::to_string(i) + (i % 3 == 0 ? ", \"Jr\"" : "");
+        std::string email32 = i % 5 == 0 ? "" : (i % 7 == 0 ? "a\r\nb" + std::to_string(i) : "c" + std::to_string(i) + "@x.com");
+        store32.insert(Contact(name32, "11 " + std::to_string(i), email32, i % 4 == 0));
+    }
+    assert(writeContactsCsv(path32, [&](const auto& visit) { store32.snapshot().forEach(visit); }));
+    CsvImport import32 = readContactsCsv(path32);
+    assert(import32.opened && import32.ok && import32.skipped == 0 && import32.contacts.size() == 2000);
+    std::size_t index32 = 0;
+    store32.snapshot().forEach([&](const Contact& contact) {
+        const Contact& read = import32.contacts[index32++];
+        assert(read.getName() == contact.getName() && read.getPhone() == contact.getPhone());
+        assert(read.getEmail() == contact.getEmail() && read.isFavorite() == contact.isFavorite());
+    });
+    std::ofstream(path32, std::ios::binary | std::ios::trunc) << "Ana,1\n,2,sem nome\nBia\n\"Caio\nx";
+    import32 = readContactsCsv(path32);
+    assert(import32.opened && !import32.ok && import32.invalidRecord == 4);
+    assert(import32.contacts.size() == 2 && import32.skipped == 1 && import32.contacts[1].getPhone().empty());
+    std::filesystem::remove(path32);
+    assert(!readContactsCsv(path32).opened);
+    std::cout << "OK!" << std::endl;
+    
     std::cout << "\nTodos os testes passaram!" << std::endl;
 }
 
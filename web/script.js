@@ -275,7 +275,11 @@ async function removeContact(contactName) {
 }
 
 // 3. Buscar Contato
-function performSearch() {
+// A busca é feita no servidor (/api/search), que percorre só os nomes com o
+// prefixo digitado em vez de enviar a agenda inteira a cada tecla
+let searchSequence = 0;
+
+async function performSearch() {
     const searchTerm = document.getElementById('globalSearch').value.trim();
     const resultsContainer = document.getElementById('searchResults');
     
@@ -284,16 +288,27 @@ function performSearch() {
         return;
     }
 
-    const filtered = contacts.filter(contact => {
-        const name = (contact.name || '').toLowerCase();
-        const phone = (contact.phone || '').toLowerCase();
-        const email = (contact.email || '').toLowerCase();
-        const search = searchTerm.toLowerCase();
+    // Respostas de buscas antigas (digitação rápida) são descartadas
+    const sequence = ++searchSequence;
+    
+    try {
+        const response = await fetch(`/api/search?q=${encodeURIComponent(searchTerm)}&limit=100`);
+        let data = await response.json();
         
-        return name.includes(search) || phone.includes(search) || email.includes(search);
-    });
-
-    displaySearchResults(filtered, searchTerm);
+        // Sem resultados exatos: tenta nomes parecidos (erros de digitação)
+        if (data.success && data.count === 0) {
+            const fuzzyResponse = await fetch(`/api/search?q=${encodeURIComponent(searchTerm)}&fuzzy=1&limit=20`);
+            data = await fuzzyResponse.json();
+        }
+        
+        if (sequence !== searchSequence) return;
+        
+        if (data.success) {
+            displaySearchResults(data.contacts || [], searchTerm);
+        }
+    } catch (error) {
+        showNotification('Erro na busca: ' + error.message, 'error');
+    }
 }
 
 function displaySearchResults(results, searchTerm) {
@@ -422,7 +437,6 @@ function calculateLocalStatistics() {
     const stats = {
         total: contacts.length,
         favorites: contacts.filter(c => c.favorite).length,
-        balanced: true, // Assumindo que está balanceado localmente
         height: Math.ceil(Math.log2(contacts.length + 1)) // Estimativa
     };
     updateStatisticsDisplay(stats);
@@ -432,7 +446,6 @@ function updateStatisticsDisplay(stats) {
     // Estatísticas principais
     document.getElementById('statTotal').textContent = stats.total || contacts.length;
     document.getElementById('statFavorites').textContent = stats.favorites || contacts.filter(c => c.favorite).length;
-    document.getElementById('statBalanced').textContent = stats.balanced ? 'Sim' : 'Não';
     document.getElementById('statHeight').textContent = stats.height || 'N/A';
     
     // Gráfico de distribuição
@@ -507,6 +520,41 @@ async function testToggleFavorite() {
     console.log('Teste de favoritos verificado');
 }
 
+// Campo de CSV (RFC 4180): entre aspas, com as aspas internas dobradas
+function csvField(value) {
+    return `"${String(value).replace(/"/g, '""')}"`;
+}
+
+// Registros de um CSV (RFC 4180): campos entre aspas podem ter vírgulas,
+// quebras de linha e aspas dobradas; linhas vazias são ignoradas
+function parseCSV(text) {
+    const records = [];
+    let record = [], field = '', quoted = false;
+    for (let i = text.charCodeAt(0) === 0xFEFF ? 1 : 0; i < text.length; i++) {
+        const c = text[i];
+        if (quoted) {
+            if (c !== '"') field += c;
+            else if (text[i + 1] === '"') field += text[i++];
+            else quoted = false;
+        } else if (c === '"') {
+            quoted = true;
+        } else if (c === ',') {
+            record.push(field);
+            field = '';
+        } else if (c === '\n') {
+            record.push(field.replace(/\r$/, ''));
+            if (record.length > 1 || record[0]) records.push(record);
+            record = [];
+            field = '';
+        } else {
+            field += c;
+        }
+    }
+    record.push(field.replace(/\r$/, ''));
+    if (record.length > 1 || record[0]) records.push(record);
+    return records;
+}
+
 // 9. Exportar para CSV
 function exportCSV() {
     if (contacts.length === 0) {
@@ -520,7 +568,7 @@ function exportCSV() {
     let csv = 'Nome,Telefone,Email,Favorito\n';
     
     sortedContacts.forEach(contact => {
-        csv += `"${contact.name || ''}","${contact.phone || ''}","${contact.email || ''}","${contact.favorite}"\n`;
+        csv += [contact.name || '', contact.phone || '', contact.email || '', contact.favorite].map(csvField).join(',') + '\n';
     });
 
     const blob = new Blob([csv], { type: 'text/csv;charset=utf-8;' });
@@ -563,7 +611,7 @@ function handleCSVFile(file) {
 }
 
 function previewCSV(csvContent) {
-    const lines = csvContent.split('\n');
+    const lines = parseCSV(csvContent);
     const preview = document.getElementById('csvPreview');
     
     if (lines.length === 0) {
@@ -577,17 +625,15 @@ function previewCSV(csvContent) {
     
     // Cabeçalho
     html += '<thead><tr>';
-    const headers = lines[0].split(',').map(h => `<th>${h.replace(/"/g, '')}</th>`).join('');
+    const headers = lines[0].map(h => `<th>${h}</th>`).join('');
     html += headers + '</tr></thead>';
     
     // Primeiras 5 linhas
     html += '<tbody>';
     for (let i = 1; i < Math.min(6, lines.length); i++) {
-        if (lines[i].trim()) {
-            html += '<tr>';
-            const cells = lines[i].split(',').map(c => `<td>${c.replace(/"/g, '')}</td>`).join('');
-            html += cells + '</tr>';
-        }
+        html += '<tr>';
+        const cells = lines[i].map(c => `<td>${c}</td>`).join('');
+        html += cells + '</tr>';
     }
     html += '</tbody>';
     html += '</table>';
@@ -602,14 +648,14 @@ function previewCSV(csvContent) {
 
 async function importCSV(base64CSV) {
     const csvContent = atob(base64CSV);
-    const lines = csvContent.split('\n');
+    const lines = parseCSV(csvContent);
     
     if (lines.length < 2) {
         showNotification('Arquivo CSV inválido', 'error');
         return;
     }
     
-    const headers = lines[0].split(',').map(h => h.replace(/"/g, '').trim());
+    const headers = lines[0].map(h => h.trim());
     const nameIndex = headers.findIndex(h => h.toLowerCase() === 'nome');
     
     if (nameIndex === -1) {
@@ -618,16 +664,14 @@ async function importCSV(base64CSV) {
     }
     
     showLoading();
-    let imported = 0;
-    let errors = 0;
+    const operations = [];
     
     for (let i = 1; i < lines.length; i++) {
-        if (!lines[i].trim()) continue;
-        
-        const cells = lines[i].split(',').map(c => c.replace(/"/g, '').trim());
+        const cells = lines[i].map(c => c.trim());
         if (cells.length < headers.length) continue;
         
         const contact = {
+            op: 'add',
             name: cells[nameIndex],
             phone: cells[headers.findIndex(h => h.toLowerCase() === 'telefone')] || '',
             email: cells[headers.findIndex(h => h.toLowerCase() === 'email')] || '',
@@ -635,25 +679,11 @@ async function importCSV(base64CSV) {
         };
         
         if (contact.name) {
-            try {
-                const response = await fetch('/api/add', {
-                    method: 'POST',
-                    headers: {'Content-Type': 'application/json'},
-                    body: JSON.stringify(contact)
-                });
-                
-                const result = await response.json();
-                if (result.success) {
-                    imported++;
-                } else {
-                    errors++;
-                }
-            } catch (error) {
-                errors++;
-            }
+            operations.push(contact);
         }
     }
     
+    const { applied: imported, failed: errors } = await sendBatch(operations);
     hideLoading();
     
     let message = `${imported} contatos importados com sucesso!`;
@@ -691,10 +721,47 @@ function exitApp() {
 }
 
 // Funções Auxiliares
+
+// Busca todas as páginas de /api/contacts, seguindo o cursor "next"
+async function fetchAllContacts() {
+    let all = [];
+    let url = '/api/contacts?limit=1000';
+    while (true) {
+        const response = await fetch(url);
+        const data = await response.json();
+        if (!data.success) return data;
+        
+        all = all.concat(data.contacts || []);
+        if (!data.next) {
+            data.contacts = all;
+            return data;
+        }
+        url = '/api/contacts?limit=1000&cursor=' + encodeURIComponent(data.next);
+    }
+}
+
+// Envia várias operações numa só requisição a /api/batch; retorna
+// quantas foram aplicadas e quantas falharam
+async function sendBatch(operations) {
+    if (operations.length === 0) return { applied: 0, failed: 0 };
+    try {
+        const response = await fetch('/api/batch', {
+            method: 'POST',
+            headers: {'Content-Type': 'application/json'},
+            body: JSON.stringify(operations)
+        });
+        
+        const result = await response.json();
+        if (result.success) return { applied: result.applied, failed: result.failed };
+    } catch (error) {
+        // Conta tudo como erro
+    }
+    return { applied: 0, failed: operations.length };
+}
+
 async function loadContacts() {
     try {
-        const response = await fetch('/api/contacts');
-        const data = await response.json();
+        const data = await fetchAllContacts();
         
         if (data.success) {
             contacts = data.contacts || [];
@@ -784,27 +851,8 @@ async function removeSelected() {
         `Tem certeza que deseja remover ${selectedContacts.size} contato(s) selecionado(s)?`,
         async () => {
             showLoading();
-            let successCount = 0;
-            let errorCount = 0;
-
-            for (const contactName of selectedContacts) {
-                try {
-                    const response = await fetch('/api/remove', {
-                        method: 'POST',
-                        headers: {'Content-Type': 'application/json'},
-                        body: JSON.stringify({ name: contactName })
-                    });
-                    
-                    const result = await response.json();
-                    if (result.success) {
-                        successCount++;
-                    } else {
-                        errorCount++;
-                    }
-                } catch (error) {
-                    errorCount++;
-                }
-            }
+            const operations = [...selectedContacts].map(name => ({ op: 'remove', name }));
+            const { applied: successCount, failed: errorCount } = await sendBatch(operations);
             
             closeConfirmModal();
             